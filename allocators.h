@@ -0,0 +1,554 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <malloc.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// malloc-backed allocator implementing Vector's try_expand/reallocate extensions.
+// On Linux, blocks of at least mmap_threshold bytes are mapped directly so that they can
+// be grown with mremap: in place when the address space after them is free, otherwise by
+// remapping the pages instead of copying them.
+template <typename T>
+class MallocAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "MallocAllocator does not support over-aligned types");
+
+public:
+    using value_type = T;
+
+    static constexpr size_t mmap_threshold = size_t(1) << 20;
+
+    MallocAllocator() noexcept = default;
+
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>&) noexcept {}
+
+    [[nodiscard]] T* allocate(size_t n) {
+        if (n > max_size()) {
+            throw std::bad_array_new_length();
+        }
+        void* p = allocate_bytes(n * sizeof(T));
+        if (!p) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        deallocate_bytes(p, n * sizeof(T));
+    }
+
+    bool try_expand(T* p, size_t oldCount, size_t newCount) noexcept {
+        size_t oldBytes = oldCount * sizeof(T);
+        size_t newBytes = newCount * sizeof(T);
+#if defined(__linux__)
+        if (is_mapped(oldBytes)) {
+            size_t oldLength = page_round(oldBytes);
+            size_t newLength = page_round(newBytes);
+            return newLength <= oldLength || mremap(p, oldLength, newLength, 0) != MAP_FAILED;
+        }
+        // crossing the threshold changes how the block must be released
+        return !is_mapped(newBytes) && newBytes <= malloc_usable_size(p);
+#else
+        (void)p;
+        return newBytes <= oldBytes;
+#endif
+    }
+
+    T* reallocate(T* p, size_t oldCount, size_t newCount) noexcept {
+        if (newCount > max_size()) {
+            return nullptr;
+        }
+        size_t oldBytes = oldCount * sizeof(T);
+        size_t newBytes = newCount * sizeof(T);
+
+        if (is_mapped(oldBytes) == is_mapped(newBytes)) {
+#if defined(__linux__)
+            if (is_mapped(oldBytes)) {
+                void* moved = mremap(p, page_round(oldBytes), page_round(newBytes), MREMAP_MAYMOVE);
+                return moved == MAP_FAILED ? nullptr : static_cast<T*>(moved);
+            }
+#endif
+            return static_cast<T*>(std::realloc(p, newBytes ? newBytes : 1));
+        }
+
+        void* moved = allocate_bytes(newBytes);
+        if (!moved) {
+            return nullptr;
+        }
+        std::memcpy(moved, static_cast<const void*>(p), oldBytes < newBytes ? oldBytes : newBytes);
+        deallocate_bytes(p, oldBytes);
+        return static_cast<T*>(moved);
+    }
+
+    [[nodiscard]] size_t max_size() const noexcept {
+        return SIZE_MAX / sizeof(T);
+    }
+
+    template <typename U>
+    bool operator==(const MallocAllocator<U>&) const noexcept {
+        return true;
+    }
+
+private:
+    static bool is_mapped(size_t bytes) noexcept {
+#if defined(__linux__)
+        return bytes >= mmap_threshold;
+#else
+        (void)bytes;
+        return false;
+#endif
+    }
+
+#if defined(__linux__)
+    static size_t page_round(size_t bytes) noexcept {
+        static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return (bytes + page - 1) & ~(page - 1);
+    }
+#endif
+
+    static void* allocate_bytes(size_t bytes) noexcept {
+#if defined(__linux__)
+        if (is_mapped(bytes)) {
+            void* p = mmap(nullptr, page_round(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            return p == MAP_FAILED ? nullptr : p;
+        }
+#endif
+        return std::malloc(bytes ? bytes : 1);
+    }
+
+    static void deallocate_bytes(void* p, size_t bytes) noexcept {
+#if defined(__linux__)
+        if (is_mapped(bytes)) {
+            munmap(p, page_round(bytes));
+            return;
+        }
+#endif
+        std::free(p);
+    }
+};
+
+// Allocator backing large blocks with huge pages to cut TLB misses on multi-GiB Vectors.
+// Blocks of at least Threshold bytes are rounded up to whole PageSize pages and mapped with
+// MAP_HUGETLB when the system has huge pages of that size reserved; otherwise they are mapped as
+// PageSize-aligned regular pages with madvise(MADV_HUGEPAGE), so transparent huge pages can back
+// them. Smaller blocks come from malloc. Pair it with HugePageGrowth so the capacities Vector asks
+// for fill the pages. PageSize may be 2 MiB or 1 GiB; transparent huge pages only exist at 2 MiB.
+template <typename T, size_t PageSize = size_t(2) << 20, size_t Threshold = PageSize>
+class HugePageAllocator {
+    static_assert((PageSize & (PageSize - 1)) == 0, "page size must be a power of two");
+    static_assert(alignof(T) <= alignof(std::max_align_t), "HugePageAllocator does not support over-aligned types");
+
+public:
+    using value_type = T;
+
+    static constexpr size_t page_size = PageSize;
+    static constexpr size_t threshold = Threshold;
+
+    template <typename U>
+    struct rebind {
+        using other = HugePageAllocator<U, PageSize, Threshold>;
+    };
+
+    HugePageAllocator() noexcept = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, PageSize, Threshold>&) noexcept {}
+
+    [[nodiscard]] T* allocate(size_t n) {
+        if (n > max_size()) {
+            throw std::bad_array_new_length();
+        }
+        void* p = allocate_bytes(n * sizeof(T));
+        if (!p) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        size_t bytes = n * sizeof(T);
+#if defined(__linux__)
+        if (is_mapped(bytes)) {
+            munmap(p, huge_round(bytes));
+            return;
+        }
+#else
+        (void)bytes;
+#endif
+        std::free(p);
+    }
+
+    bool try_expand(T* p, size_t oldCount, size_t newCount) noexcept {
+        size_t oldBytes = oldCount * sizeof(T);
+        size_t newBytes = newCount * sizeof(T);
+#if defined(__linux__)
+        if (is_mapped(oldBytes)) {
+            size_t oldLength = huge_round(oldBytes);
+            size_t newLength = huge_round(newBytes);
+            return newLength <= oldLength || mremap(p, oldLength, newLength, 0) != MAP_FAILED;
+        }
+        return !is_mapped(newBytes) && newBytes <= malloc_usable_size(p);
+#else
+        (void)p;
+        return newBytes <= oldBytes;
+#endif
+    }
+
+    [[nodiscard]] size_t max_size() const noexcept {
+        return (SIZE_MAX - PageSize) / sizeof(T);
+    }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U, PageSize, Threshold>&) const noexcept {
+        return true;
+    }
+
+private:
+    static bool is_mapped(size_t bytes) noexcept {
+#if defined(__linux__)
+        return bytes >= Threshold;
+#else
+        (void)bytes;
+        return false;
+#endif
+    }
+
+    static constexpr size_t huge_round(size_t bytes) noexcept {
+        return (bytes + PageSize - 1) & ~(PageSize - 1);
+    }
+
+    static void* allocate_bytes(size_t bytes) noexcept {
+#if defined(__linux__)
+        if (is_mapped(bytes)) {
+            size_t length = huge_round(bytes);
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+            int hugeFlags = MAP_HUGETLB | (std::countr_zero(PageSize) << MAP_HUGE_SHIFT);
+            void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | hugeFlags, -1, 0);
+            if (p != MAP_FAILED) {
+                return p;
+            }
+#endif
+            // no reserved huge pages: over-map, trim to a PageSize-aligned window and ask for THP
+            void* raw = mmap(nullptr, length + PageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED) {
+                return nullptr;
+            }
+            char* base = static_cast<char*>(raw);
+            char* aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(base) + PageSize - 1) & ~(PageSize - 1));
+            if (aligned != base) {
+                munmap(base, static_cast<size_t>(aligned - base));
+            }
+            size_t tail = static_cast<size_t>(base + length + PageSize - (aligned + length));
+            if (tail) {
+                munmap(aligned + length, tail);
+            }
+#if defined(MADV_HUGEPAGE)
+            madvise(aligned, length, MADV_HUGEPAGE);
+#endif
+            return aligned;
+        }
+#endif
+        return std::malloc(bytes ? bytes : 1);
+    }
+};
+
+// Allocator returning blocks aligned to Align bytes (cache lines, SIMD registers, DMA pages).
+// Vector picks up the alignment through the static alignment member, see Vector::aligned_data.
+template <typename T, size_t Align = 64>
+class AlignedAllocator {
+    static_assert((Align & (Align - 1)) == 0, "alignment must be a power of two");
+    static_assert(Align >= alignof(T), "alignment must not be weaker than alignof(T)");
+
+public:
+    using value_type = T;
+
+    static constexpr size_t alignment = Align;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Align>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) noexcept {}
+
+    [[nodiscard]] T* allocate(size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        ::operator delete(p, n * sizeof(T), std::align_val_t(Align));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Align>&) const noexcept {
+        return true;
+    }
+};
+
+// Bump-pointer arena for short-lived containers. Memory is only returned when the arena is
+// released or destroyed; deallocating the most recent block merely rewinds the cursor, and the
+// most recent block can be grown in place while the current chunk has room.
+class Arena {
+public:
+    explicit Arena(size_t initialChunkBytes = 64 * 1024) noexcept
+        : nextChunkBytes_(std::max<size_t>(initialChunkBytes, sizeof(Chunk) + alignof(std::max_align_t))) {
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena() { release(); }
+
+    [[nodiscard]] void* allocate(size_t bytes, size_t align) {
+        char* p = align_up(cursor_, align);
+        if (!cursor_ || p > end_ || bytes > static_cast<size_t>(end_ - p)) {
+            add_chunk(bytes + align);
+            p = align_up(cursor_, align);
+        }
+        cursor_ = p + bytes;
+        return p;
+    }
+
+    void deallocate(void* p, size_t bytes) noexcept {
+        if (static_cast<char*>(p) + bytes == cursor_) {
+            cursor_ = static_cast<char*>(p);
+        }
+    }
+
+    bool try_expand(void* p, size_t oldBytes, size_t newBytes) noexcept {
+        char* block = static_cast<char*>(p);
+        if (block + oldBytes != cursor_ || newBytes < oldBytes || newBytes - oldBytes > static_cast<size_t>(end_ - cursor_)) {
+            return false;
+        }
+        cursor_ = block + newBytes;
+        return true;
+    }
+
+    // Frees every chunk; all memory handed out by the arena becomes invalid.
+    void release() noexcept {
+        while (head_) {
+            Chunk* next = head_->next;
+            ::operator delete(head_);
+            head_ = next;
+        }
+        cursor_ = nullptr;
+        end_ = nullptr;
+    }
+
+private:
+    struct alignas(std::max_align_t) Chunk {
+        Chunk* next;
+    };
+
+    static char* align_up(char* p, size_t align) noexcept {
+        auto address = reinterpret_cast<uintptr_t>(p);
+        return p + ((align - address % align) % align);
+    }
+
+    void add_chunk(size_t minBytes) {
+        size_t bytes = std::max(nextChunkBytes_, minBytes + sizeof(Chunk));
+        auto* chunk = static_cast<Chunk*>(::operator new(bytes));
+        chunk->next = head_;
+        head_ = chunk;
+        cursor_ = reinterpret_cast<char*>(chunk + 1);
+        end_ = reinterpret_cast<char*>(chunk) + bytes;
+        nextChunkBytes_ = bytes * 2;
+    }
+
+    Chunk* head_ = nullptr;
+    char* cursor_ = nullptr;
+    char* end_ = nullptr;
+    size_t nextChunkBytes_;
+};
+
+// Allocator handle onto an Arena. Vectors using it never free individually, and growth of the
+// most recently allocated Vector extends in place through try_expand.
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    explicit ArenaAllocator(Arena& arena) noexcept : arena_(&arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    [[nodiscard]] T* allocate(size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        arena_->deallocate(p, n * sizeof(T));
+    }
+
+    bool try_expand(T* p, size_t oldCount, size_t newCount) noexcept {
+        return newCount <= SIZE_MAX / sizeof(T) && arena_->try_expand(p, oldCount * sizeof(T), newCount * sizeof(T));
+    }
+
+    [[nodiscard]] Arena* arena() const noexcept {
+        return arena_;
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ == other.arena();
+    }
+
+private:
+    Arena* arena_;
+};
+
+// Size-class pool: requests up to max_pooled bytes are rounded up to a power of two (at least
+// 16 bytes) and recycled through one free list per class; larger ones go to operator new.
+class Pool {
+public:
+    static constexpr size_t min_pooled = 16;
+    static constexpr size_t max_pooled = 64 * 1024;
+
+    explicit Pool(size_t slabBytes = 256 * 1024) noexcept
+        : slabBytes_(std::max(slabBytes, max_pooled + sizeof(Slab))) {
+    }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    ~Pool() {
+        while (slabs_) {
+            Slab* next = slabs_->next;
+            ::operator delete(slabs_);
+            slabs_ = next;
+        }
+    }
+
+    // Usable size of a block obtained for the given request.
+    static constexpr size_t block_size(size_t bytes) noexcept {
+        return bytes > max_pooled ? bytes : std::bit_ceil(std::max(bytes, min_pooled));
+    }
+
+    [[nodiscard]] void* allocate(size_t bytes) {
+        if (bytes > max_pooled) {
+            return ::operator new(bytes);
+        }
+        size_t sizeClass = class_of(bytes);
+        if (FreeNode* node = free_[sizeClass]) {
+            free_[sizeClass] = node->next;
+            return node;
+        }
+        return carve(block_size(bytes));
+    }
+
+    void deallocate(void* p, size_t bytes) noexcept {
+        if (bytes > max_pooled) {
+            ::operator delete(p);
+            return;
+        }
+        size_t sizeClass = class_of(bytes);
+        auto* node = static_cast<FreeNode*>(p);
+        node->next = free_[sizeClass];
+        free_[sizeClass] = node;
+    }
+
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    struct alignas(std::max_align_t) Slab {
+        Slab* next;
+    };
+
+    static constexpr size_t class_count = std::countr_zero(max_pooled) - std::countr_zero(min_pooled) + 1;
+
+    static constexpr size_t class_of(size_t bytes) noexcept {
+        return std::countr_zero(block_size(bytes)) - std::countr_zero(min_pooled);
+    }
+
+    void* carve(size_t bytes) {
+        if (static_cast<size_t>(end_ - cursor_) < bytes) {
+            auto* slab = static_cast<Slab*>(::operator new(slabBytes_));
+            slab->next = slabs_;
+            slabs_ = slab;
+            cursor_ = reinterpret_cast<char*>(slab + 1);
+            end_ = reinterpret_cast<char*>(slab) + slabBytes_;
+        }
+        void* p = cursor_;
+        cursor_ += bytes;
+        return p;
+    }
+
+    FreeNode* free_[class_count] = {};
+    Slab* slabs_ = nullptr;
+    char* cursor_ = nullptr;
+    char* end_ = nullptr;
+    size_t slabBytes_;
+};
+
+// Allocator handle onto a Pool. Growth within the same size class happens in place.
+template <typename T>
+class PoolAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "PoolAllocator does not support over-aligned types");
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    explicit PoolAllocator(Pool& pool) noexcept : pool_(&pool) {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : pool_(other.pool()) {}
+
+    [[nodiscard]] T* allocate(size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(pool_->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        pool_->deallocate(p, n * sizeof(T));
+    }
+
+    bool try_expand(T*, size_t oldCount, size_t newCount) noexcept {
+        size_t oldBytes = oldCount * sizeof(T);
+        size_t newBytes = newCount * sizeof(T);
+        return newCount <= SIZE_MAX / sizeof(T) && oldBytes <= Pool::max_pooled && newBytes <= Pool::max_pooled
+            && Pool::block_size(oldBytes) == Pool::block_size(newBytes);
+    }
+
+    [[nodiscard]] Pool* pool() const noexcept {
+        return pool_;
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const noexcept {
+        return pool_ == other.pool();
+    }
+
+private:
+    Pool* pool_;
+};
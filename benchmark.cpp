@@ -0,0 +1,858 @@
+// Benchmark suite: Vector against std::vector across operations, element types and sizes.
+//
+//     g++ -std=c++20 -O2 -DNDEBUG benchmark.cpp -o benchmark
+//     ./benchmark [--filter=push_back/int] [--max-size=100000000] [--max-mib=1024]
+//                 [--min-time-ms=20] [--repetitions=5]
+//     ./benchmark --json=baseline.jsonl
+//     ./benchmark --baseline=baseline.jsonl [--time-threshold=1.25] [--alloc-threshold=0] [--max-ratio=R]
+//
+// Every case is calibrated until one sample takes at least --min-time-ms, then sampled --repetitions
+// times; the table reports the median per operation. Element types are int, a 64-byte POD, a heap
+// allocated std::string and a move-only type; sizes run from 16 to 10^8, skipping cases whose working
+// set exceeds --max-mib. Results are kept alive with do_not_optimize/clobber_memory so the optimizer
+// cannot drop the measured work. Cycles and cache misses come from perf_event_open on Linux and show
+// as "-" where the kernel does not allow it; allocations are counted by replacing global operator new
+// and, on glibc, malloc and friends. --baseline compares a run against JSON lines written by --json and
+// exits with status 1 on any regression past the thresholds.
+#include "vector.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Every heap allocation the process makes: operator new below, plus malloc, calloc, realloc and the
+// aligned variants where the C library lets them be interposed (glibc, outside sanitizer builds).
+uint64_t allocation_count = 0;
+uint64_t allocation_bytes = 0;
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+#define BENCHMARK_COUNT_MALLOC 1
+#endif
+
+#ifdef BENCHMARK_COUNT_MALLOC
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void* __libc_memalign(size_t, size_t);
+extern "C" void __libc_free(void*);
+
+void* raw_malloc(size_t size) { return __libc_malloc(size); }
+void* raw_aligned(size_t alignment, size_t size) { return __libc_memalign(alignment, size); }
+void raw_free(void* p) { __libc_free(p); }
+#else
+void* raw_malloc(size_t size) { return std::malloc(size); }
+void* raw_aligned(size_t alignment, size_t size) {
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+void raw_free(void* p) { std::free(p); }
+#endif
+
+void* counted_new(size_t size, size_t alignment = 0) {
+    ++allocation_count;
+    allocation_bytes += size;
+    void* p = alignment > alignof(std::max_align_t) ? raw_aligned(alignment, size) : raw_malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+}
+
+#ifdef BENCHMARK_COUNT_MALLOC
+extern "C" {
+
+void* malloc(size_t size) {
+    ++allocation_count;
+    allocation_bytes += size;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    ++allocation_count;
+    allocation_bytes += count * size;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* p, size_t size) {
+    ++allocation_count;
+    allocation_bytes += size;
+    return __libc_realloc(p, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    ++allocation_count;
+    allocation_bytes += size;
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) {
+    ++allocation_count;
+    allocation_bytes += size;
+    void* p = __libc_memalign(alignment, size);
+    if (!p) {
+        return ENOMEM;
+    }
+    *out = p;
+    return 0;
+}
+
+void free(void* p) { __libc_free(p); }
+
+}
+#endif
+
+void* operator new(size_t size) { return counted_new(size); }
+void* operator new[](size_t size) { return counted_new(size); }
+void* operator new(size_t size, std::align_val_t al) { return counted_new(size, static_cast<size_t>(al)); }
+void* operator new[](size_t size, std::align_val_t al) { return counted_new(size, static_cast<size_t>(al)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return counted_new(size);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return counted_new(size);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+void operator delete(void* p) noexcept { raw_free(p); }
+void operator delete[](void* p) noexcept { raw_free(p); }
+void operator delete(void* p, size_t) noexcept { raw_free(p); }
+void operator delete[](void* p, size_t) noexcept { raw_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { raw_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { raw_free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { raw_free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { raw_free(p); }
+
+namespace {
+
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+inline void clobber_memory() {
+#if defined(__GNUC__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+// Hardware cycle and cache-miss counters for the calling thread, read as one perf event group.
+class PerfCounters {
+public:
+    PerfCounters() {
+#if defined(__linux__)
+        cycles_ = open(PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (cycles_ >= 0) {
+            misses_ = open(PERF_COUNT_HW_CACHE_MISSES, cycles_);
+        }
+        if (misses_ < 0 && cycles_ >= 0) {
+            ::close(cycles_);
+            cycles_ = -1;
+        }
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        if (misses_ >= 0) {
+            ::close(misses_);
+        }
+        if (cycles_ >= 0) {
+            ::close(cycles_);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    [[nodiscard]] bool available() const noexcept { return cycles_ >= 0; }
+
+    void start() noexcept {
+#if defined(__linux__)
+        if (available()) {
+            ::ioctl(cycles_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ::ioctl(cycles_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    // Cycles and cache misses since start().
+    std::array<uint64_t, 2> stop() noexcept {
+        std::array<uint64_t, 2> result{};
+#if defined(__linux__)
+        if (available()) {
+            ::ioctl(cycles_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+            uint64_t values[3] = {};
+            if (::read(cycles_, values, sizeof(values)) == static_cast<ssize_t>(sizeof(values))) {
+                result = {values[1], values[2]};
+            }
+        }
+#endif
+        return result;
+    }
+
+private:
+#if defined(__linux__)
+    static int open(uint64_t config, int group) noexcept {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = group < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+    }
+#endif
+
+    int cycles_ = -1;
+    int misses_ = -1;
+};
+
+struct Options {
+    std::string filter;
+    size_t max_size = 100000000;
+    size_t max_bytes = size_t(1) << 30;
+    double min_time_ms = 20;
+    int repetitions = 5;
+    std::string json;
+    std::string baseline;
+    double time_threshold = 1.25;   // fail when ns/op exceeds the baseline by this factor; 0 disables
+    double alloc_threshold = 0;     // relative slack for allocs/op and bytes/op against the baseline
+    double max_ratio = 0;           // fail when Vector is this much slower than std::vector; 0 disables
+};
+
+struct Measurement {
+    double ns_per_op = 0;
+    double cycles_per_op = -1;
+    double misses_per_op = -1;
+    double allocs_per_op = 0;
+    double bytes_per_op = 0;
+};
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    size_t mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+}
+
+// run(iterations) repeats the measured work; every repetition performs ops operations.
+Measurement measure(const std::function<void(size_t)>& run, size_t ops, const Options& options, PerfCounters& perf) {
+    using clock = std::chrono::steady_clock;
+    auto elapsed_ms = [&](size_t iterations) {
+        auto start = clock::now();
+        run(iterations);
+        return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    };
+
+    size_t iterations = 1;
+    for (double ms = elapsed_ms(iterations); ms < options.min_time_ms;) {
+        size_t factor = ms > 0 ? static_cast<size_t>(options.min_time_ms / ms * 1.2) + 1 : 10;
+        iterations *= std::clamp<size_t>(factor, 2, 10);
+        ms = elapsed_ms(iterations);
+    }
+
+    std::vector<double> ns, cycles, misses, allocs, bytes;
+    for (int r = 0; r < options.repetitions; ++r) {
+        uint64_t count = allocation_count;
+        uint64_t size = allocation_bytes;
+        perf.start();
+        auto start = clock::now();
+        run(iterations);
+        auto stop = clock::now();
+        auto hw = perf.stop();
+        count = allocation_count - count;
+        size = allocation_bytes - size;
+        double total = static_cast<double>(iterations) * static_cast<double>(ops);
+        ns.push_back(std::chrono::duration<double, std::nano>(stop - start).count() / total);
+        cycles.push_back(static_cast<double>(hw[0]) / total);
+        misses.push_back(static_cast<double>(hw[1]) / total);
+        allocs.push_back(static_cast<double>(count) / total);
+        bytes.push_back(static_cast<double>(size) / total);
+    }
+
+    Measurement m;
+    m.ns_per_op = median(ns);
+    if (perf.available()) {
+        m.cycles_per_op = median(cycles);
+        m.misses_per_op = median(misses);
+    }
+    m.allocs_per_op = median(allocs);
+    m.bytes_per_op = median(bytes);
+    return m;
+}
+
+struct Result {
+    std::string name;
+    std::string container;
+    Measurement m;
+};
+
+// Results are stored as JSON lines, one object per case and container, the same shape vector_stats::dump
+// uses; metrics that were not measured are written as null.
+void write_json(const std::vector<Result>& results, std::FILE* out) {
+    auto metric = [out](const char* key, double value) {
+        if (value >= 0) {
+            std::fprintf(out, ",\"%s\":%.9g", key, value);
+        }
+        else {
+            std::fprintf(out, ",\"%s\":null", key);
+        }
+    };
+    for (const Result& r : results) {
+        std::fprintf(out, "{\"name\":\"%s\",\"container\":\"%s\"", r.name.c_str(), r.container.c_str());
+        metric("ns_per_op", r.m.ns_per_op);
+        metric("cycles_per_op", r.m.cycles_per_op);
+        metric("misses_per_op", r.m.misses_per_op);
+        metric("allocs_per_op", r.m.allocs_per_op);
+        metric("bytes_per_op", r.m.bytes_per_op);
+        std::fprintf(out, "}\n");
+    }
+}
+
+// Reads back what write_json produced; lines it does not understand are skipped.
+std::vector<Result> read_json(std::FILE* in) {
+    auto text = [](std::string_view line, std::string_view key) {
+        std::string pattern = "\"" + std::string(key) + "\":\"";
+        size_t first = line.find(pattern);
+        if (first == std::string_view::npos) {
+            return std::string();
+        }
+        first += pattern.size();
+        return std::string(line.substr(first, line.find('"', first) - first));
+    };
+    auto number = [](std::string_view line, std::string_view key) {
+        std::string pattern = "\"" + std::string(key) + "\":";
+        size_t first = line.find(pattern);
+        if (first == std::string_view::npos || line.substr(first + pattern.size(), 4) == "null") {
+            return -1.0;
+        }
+        return std::strtod(std::string(line.substr(first + pattern.size())).c_str(), nullptr);
+    };
+
+    std::vector<Result> results;
+    std::string line;
+    for (int c = std::fgetc(in); c != EOF; c = std::fgetc(in)) {
+        if (c != '\n') {
+            line.push_back(static_cast<char>(c));
+            continue;
+        }
+        Result r{text(line, "name"), text(line, "container"), {}};
+        if (!r.name.empty() && !r.container.empty()) {
+            r.m.ns_per_op = number(line, "ns_per_op");
+            r.m.cycles_per_op = number(line, "cycles_per_op");
+            r.m.misses_per_op = number(line, "misses_per_op");
+            r.m.allocs_per_op = number(line, "allocs_per_op");
+            r.m.bytes_per_op = number(line, "bytes_per_op");
+            results.push_back(std::move(r));
+        }
+        line.clear();
+    }
+    return results;
+}
+
+// Reports every result that regressed past the thresholds and returns how many did. Allocation counts
+// are deterministic for a given build, so by default any increase fails; wall time gets a noise margin.
+size_t check_regressions(const std::vector<Result>& results, const std::vector<Result>& baseline,
+    const Options& options) {
+    size_t regressions = 0;
+    auto report = [&](const Result& r, const char* metric, double was, double now) {
+        std::printf("REGRESSION %s [%s] %s: %.3f -> %.3f\n", r.name.c_str(), r.container.c_str(), metric, was, now);
+        ++regressions;
+    };
+
+    for (const Result& r : results) {
+        auto old = std::find_if(baseline.begin(), baseline.end(), [&](const Result& b) {
+            return b.name == r.name && b.container == r.container;
+        });
+        if (old == baseline.end()) {
+            continue;
+        }
+        if (options.time_threshold > 0 && old->m.ns_per_op > 0
+            && r.m.ns_per_op > old->m.ns_per_op * options.time_threshold) {
+            report(r, "ns/op", old->m.ns_per_op, r.m.ns_per_op);
+        }
+        double slack = 1 + options.alloc_threshold;
+        if (old->m.allocs_per_op >= 0 && r.m.allocs_per_op > old->m.allocs_per_op * slack + 1e-9) {
+            report(r, "allocs/op", old->m.allocs_per_op, r.m.allocs_per_op);
+        }
+        if (old->m.bytes_per_op >= 0 && r.m.bytes_per_op > old->m.bytes_per_op * slack + 1e-9) {
+            report(r, "bytes/op", old->m.bytes_per_op, r.m.bytes_per_op);
+        }
+    }
+
+    if (options.max_ratio > 0) {
+        for (const Result& r : results) {
+            if (r.container != "Vector") {
+                continue;
+            }
+            auto reference = std::find_if(results.begin(), results.end(), [&](const Result& s) {
+                return s.name == r.name && s.container == "std::vector";
+            });
+            if (reference != results.end() && reference->m.ns_per_op > 0
+                && r.m.ns_per_op > reference->m.ns_per_op * options.max_ratio) {
+                report(r, "ns/op vs std::vector", reference->m.ns_per_op, r.m.ns_per_op);
+            }
+        }
+    }
+    return regressions;
+}
+
+// Element types.
+struct Pod64 {
+    int64_t values[8];
+
+    bool operator==(const Pod64& other) const noexcept {
+        return std::memcmp(values, other.values, sizeof(values)) == 0;
+    }
+};
+
+struct MoveOnly {
+    std::unique_ptr<int64_t> value;
+
+    MoveOnly() = default;
+    explicit MoveOnly(int64_t v) : value(std::make_unique<int64_t>(v)) {}
+    MoveOnly(MoveOnly&&) noexcept = default;
+    MoveOnly& operator=(MoveOnly&&) noexcept = default;
+
+    bool operator==(const MoveOnly& other) const noexcept {
+        return value && other.value && *value == *other.value;
+    }
+};
+
+template <typename T>
+struct element;
+
+template <>
+struct element<int> {
+    static constexpr std::string_view name = "int";
+    static constexpr size_t heap_bytes = 0;
+    static int make(size_t i) { return static_cast<int>(i); }
+};
+
+template <>
+struct element<Pod64> {
+    static constexpr std::string_view name = "pod64";
+    static constexpr size_t heap_bytes = 0;
+    static Pod64 make(size_t i) {
+        Pod64 pod{};
+        pod.values[0] = static_cast<int64_t>(i);
+        return pod;
+    }
+};
+
+template <>
+struct element<std::string> {
+    static constexpr std::string_view name = "string";
+    static constexpr size_t heap_bytes = 33;
+    // Long enough to defeat the small-string buffer, so every element owns a heap block.
+    static std::string make(size_t i) {
+        std::string s = "element-000000000000000000000000";
+        std::string digits = std::to_string(i);
+        s.replace(s.size() - digits.size(), digits.size(), digits);
+        return s;
+    }
+};
+
+template <>
+struct element<MoveOnly> {
+    static constexpr std::string_view name = "move_only";
+    static constexpr size_t heap_bytes = sizeof(int64_t);
+    static MoveOnly make(size_t i) { return MoveOnly(static_cast<int64_t>(i)); }
+};
+
+// The few places where Vector's API differs from std::vector's.
+template <typename V>
+constexpr bool is_std_vector = false;
+
+template <typename T, typename A>
+constexpr bool is_std_vector<std::vector<T, A>> = true;
+
+template <typename V, typename T>
+void insert_at(V& v, size_t index, const T& value) {
+    if constexpr (is_std_vector<V>) {
+        v.insert(v.begin() + static_cast<std::ptrdiff_t>(index), value);
+    }
+    else {
+        v.insert(value, index);
+    }
+}
+
+template <typename V>
+void erase_at(V& v, size_t index) {
+    if constexpr (is_std_vector<V>) {
+        v.erase(v.begin() + static_cast<std::ptrdiff_t>(index));
+    }
+    else {
+        v.erase(index);
+    }
+}
+
+template <typename V, typename T>
+size_t find_index(const V& v, const T& value) {
+    if constexpr (is_std_vector<V>) {
+        return static_cast<size_t>(std::find(v.begin(), v.end(), value) - v.begin());
+    }
+    else {
+        return v.index(value);
+    }
+}
+
+template <typename V>
+V filled(size_t n) {
+    using T = typename V::value_type;
+    V v;
+    v.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        v.push_back(element<T>::make(i));
+    }
+    return v;
+}
+
+// A benchmark case: setup(n) prepares its state and returns the loop to time plus the number of
+// operations one pass performs.
+struct Case {
+    std::string_view name;
+    std::function<std::pair<std::function<void(size_t)>, size_t>(size_t)> setup;
+    size_t footprint_factor = 1;
+};
+
+template <typename V>
+std::vector<Case> cases() {
+    using T = typename V::value_type;
+    using E = element<T>;
+    std::vector<Case> result;
+
+    result.push_back({"push_back", [](size_t n) {
+        return std::pair{std::function<void(size_t)>([n](size_t iterations) {
+            for (size_t it = 0; it < iterations; ++it) {
+                V v;
+                for (size_t i = 0; i < n; ++i) {
+                    v.push_back(E::make(i));
+                }
+                do_not_optimize(v.data());
+                clobber_memory();
+            }
+        }), n};
+    }});
+
+    result.push_back({"emplace_back", [](size_t n) {
+        return std::pair{std::function<void(size_t)>([n](size_t iterations) {
+            for (size_t it = 0; it < iterations; ++it) {
+                V v;
+                for (size_t i = 0; i < n; ++i) {
+                    v.emplace_back();
+                }
+                do_not_optimize(v.data());
+                clobber_memory();
+            }
+        }), n};
+    }});
+
+    result.push_back({"reserve_push_back", [](size_t n) {
+        return std::pair{std::function<void(size_t)>([n](size_t iterations) {
+            for (size_t it = 0; it < iterations; ++it) {
+                V v;
+                v.reserve(n);
+                for (size_t i = 0; i < n; ++i) {
+                    v.push_back(E::make(i));
+                }
+                do_not_optimize(v.data());
+                clobber_memory();
+            }
+        }), n};
+    }});
+
+    result.push_back({"pop_back", [](size_t n) {
+        auto v = std::make_shared<V>(filled<V>(n));
+        return std::pair{std::function<void(size_t)>([v, n](size_t iterations) {
+            for (size_t it = 0; it < iterations; ++it) {
+                for (size_t i = 0; i < n; ++i) {
+                    v->pop_back();
+                }
+                clobber_memory();
+                for (size_t i = 0; i < n; ++i) {
+                    v->emplace_back();
+                }
+                do_not_optimize(v->data());
+            }
+        }), n};
+    }});
+
+    result.push_back({"random_access", [](size_t n) {
+        auto v = std::make_shared<V>(filled<V>(n));
+        auto indices = std::make_shared<std::vector<uint32_t>>(std::min<size_t>(n, 1 << 16));
+        std::mt19937 gen(42);
+        for (auto& index : *indices) {
+            index = static_cast<uint32_t>(gen() % n);
+        }
+        return std::pair{std::function<void(size_t)>([v, indices](size_t iterations) {
+            for (size_t it = 0; it < iterations; ++it) {
+                for (uint32_t index : *indices) {
+                    do_not_optimize((*v)[index]);
+                }
+            }
+        }), indices->size()};
+    }});
+
+    if constexpr (std::is_copy_constructible_v<T>) {
+        result.push_back({"insert_erase_front", [](size_t n) {
+            auto v = std::make_shared<V>(filled<V>(n));
+            auto value = std::make_shared<T>(E::make(n));
+            return std::pair{std::function<void(size_t)>([v, value](size_t iterations) {
+                for (size_t it = 0; it < iterations; ++it) {
+                    insert_at(*v, 0, *value);
+                    erase_at(*v, 0);
+                    clobber_memory();
+                }
+            }), size_t(1)};
+        }});
+
+        result.push_back({"insert_erase_middle", [](size_t n) {
+            auto v = std::make_shared<V>(filled<V>(n));
+            auto value = std::make_shared<T>(E::make(n));
+            return std::pair{std::function<void(size_t)>([v, value, n](size_t iterations) {
+                for (size_t it = 0; it < iterations; ++it) {
+                    insert_at(*v, n / 2, *value);
+                    erase_at(*v, n / 2);
+                    clobber_memory();
+                }
+            }), size_t(1)};
+        }});
+
+        result.push_back({"copy", [](size_t n) {
+            auto v = std::make_shared<V>(filled<V>(n));
+            return std::pair{std::function<void(size_t)>([v](size_t iterations) {
+                for (size_t it = 0; it < iterations; ++it) {
+                    V copy(*v);
+                    do_not_optimize(copy.data());
+                    clobber_memory();
+                }
+            }), n};
+        }, 2});
+    }
+
+    result.push_back({"move", [](size_t n) {
+        auto v = std::make_shared<V>(filled<V>(n));
+        return std::pair{std::function<void(size_t)>([v](size_t iterations) {
+            for (size_t it = 0; it < iterations; ++it) {
+                V moved(std::move(*v));
+                do_not_optimize(moved.data());
+                *v = std::move(moved);
+                clobber_memory();
+            }
+        }), size_t(1)};
+    }});
+
+    result.push_back({"reserve_shrink_to_fit", [](size_t n) {
+        auto v = std::make_shared<V>(filled<V>(n));
+        v->shrink_to_fit();
+        return std::pair{std::function<void(size_t)>([v, n](size_t iterations) {
+            for (size_t it = 0; it < iterations; ++it) {
+                v->reserve(2 * n);
+                v->shrink_to_fit();
+                do_not_optimize(v->data());
+                clobber_memory();
+            }
+        }), n};
+    }, 3});
+
+    result.push_back({"find", [](size_t n) {
+        auto v = std::make_shared<V>(filled<V>(n));
+        auto needle = std::make_shared<T>(E::make(n - 1));
+        return std::pair{std::function<void(size_t)>([v, needle](size_t iterations) {
+            for (size_t it = 0; it < iterations; ++it) {
+                size_t index = find_index(*v, *needle);
+                do_not_optimize(index);
+                clobber_memory();
+            }
+        }), n};
+    }});
+
+    return result;
+}
+
+void print_measurement(std::string_view container, const Measurement& m, double baseline_ns) {
+    std::printf("  %-12.*s %12.2f", static_cast<int>(container.size()), container.data(), m.ns_per_op);
+    if (m.cycles_per_op >= 0) {
+        std::printf(" %12.2f %10.3f", m.cycles_per_op, m.misses_per_op);
+    }
+    else {
+        std::printf(" %12s %10s", "-", "-");
+    }
+    std::printf(" %10.3f %12.1f", m.allocs_per_op, m.bytes_per_op);
+    if (baseline_ns > 0) {
+        std::printf(" %8.3f", m.ns_per_op / baseline_ns);
+    }
+    std::printf("\n");
+}
+
+template <typename T>
+void run_type(const Options& options, PerfCounters& perf, std::vector<Result>& results) {
+    static constexpr size_t sizes[] = {16, 256, 4096, 65536, size_t(1) << 20, 10000000, 100000000};
+    auto std_cases = cases<std::vector<T>>();
+    auto custom_cases = cases<Vector<T>>();
+
+    for (size_t c = 0; c < custom_cases.size(); ++c) {
+        for (size_t n : sizes) {
+            size_t footprint = n * (sizeof(T) + element<T>::heap_bytes) * custom_cases[c].footprint_factor;
+            if (n > options.max_size || footprint > options.max_bytes) {
+                continue;
+            }
+            std::string name = std::string(custom_cases[c].name) + "/" + std::string(element<T>::name) + "/"
+                + std::to_string(n);
+            if (name.find(options.filter) == std::string::npos) {
+                continue;
+            }
+
+            std::printf("%s\n", name.c_str());
+            Measurement std_result;
+            {
+                auto [run, ops] = std_cases[c].setup(n);
+                std_result = measure(run, ops, options, perf);
+            }
+            print_measurement("std::vector", std_result, 0);
+            Measurement custom_result;
+            {
+                auto [run, ops] = custom_cases[c].setup(n);
+                custom_result = measure(run, ops, options, perf);
+            }
+            print_measurement("Vector", custom_result, std_result.ns_per_op);
+            std::fflush(stdout);
+            results.push_back({name, "std::vector", std_result});
+            results.push_back({name, "Vector", custom_result});
+        }
+    }
+}
+
+bool parse_option(std::string_view arg, std::string_view name, std::string_view& value) {
+    if (arg.substr(0, name.size()) != name || arg.size() <= name.size() || arg[name.size()] != '=') {
+        return false;
+    }
+    value = arg.substr(name.size() + 1);
+    return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        std::string_view value;
+        if (parse_option(arg, "--filter", value)) {
+            options.filter = std::string(value);
+        }
+        else if (parse_option(arg, "--max-size", value)) {
+            options.max_size = std::strtoull(std::string(value).c_str(), nullptr, 10);
+        }
+        else if (parse_option(arg, "--max-mib", value)) {
+            options.max_bytes = std::strtoull(std::string(value).c_str(), nullptr, 10) << 20;
+        }
+        else if (parse_option(arg, "--min-time-ms", value)) {
+            options.min_time_ms = std::strtod(std::string(value).c_str(), nullptr);
+        }
+        else if (parse_option(arg, "--repetitions", value)) {
+            options.repetitions = std::max(1, std::atoi(std::string(value).c_str()));
+        }
+        else if (parse_option(arg, "--json", value)) {
+            options.json = std::string(value);
+        }
+        else if (parse_option(arg, "--baseline", value)) {
+            options.baseline = std::string(value);
+        }
+        else if (parse_option(arg, "--time-threshold", value)) {
+            options.time_threshold = std::strtod(std::string(value).c_str(), nullptr);
+        }
+        else if (parse_option(arg, "--alloc-threshold", value)) {
+            options.alloc_threshold = std::strtod(std::string(value).c_str(), nullptr);
+        }
+        else if (parse_option(arg, "--max-ratio", value)) {
+            options.max_ratio = std::strtod(std::string(value).c_str(), nullptr);
+        }
+        else {
+            std::fprintf(stderr,
+                "usage: %s [--filter=substring] [--max-size=N] [--max-mib=N] [--min-time-ms=N] [--repetitions=N]\n"
+                "          [--json=results.jsonl] [--baseline=baseline.jsonl] [--time-threshold=1.25]\n"
+                "          [--alloc-threshold=0] [--max-ratio=R]\n",
+                argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<Result> baseline;
+    if (!options.baseline.empty()) {
+        std::FILE* in = std::fopen(options.baseline.c_str(), "r");
+        if (!in) {
+            std::fprintf(stderr, "cannot open baseline %s\n", options.baseline.c_str());
+            return 2;
+        }
+        baseline = read_json(in);
+        std::fclose(in);
+    }
+
+    PerfCounters perf;
+    std::printf("%-14s %12s %12s %10s %10s %12s %8s\n", "case", "ns/op", "cycles/op", "misses/op", "allocs/op",
+        "bytes/op", "ratio");
+    if (!perf.available()) {
+        std::printf("(hardware counters unavailable: perf_event_open was refused)\n");
+    }
+    std::vector<Result> results;
+    run_type<int>(options, perf, results);
+    run_type<Pod64>(options, perf, results);
+    run_type<std::string>(options, perf, results);
+    run_type<MoveOnly>(options, perf, results);
+
+    if (!options.json.empty()) {
+        std::FILE* out = std::fopen(options.json.c_str(), "w");
+        if (!out) {
+            std::fprintf(stderr, "cannot write %s\n", options.json.c_str());
+            return 2;
+        }
+        write_json(results, out);
+        std::fclose(out);
+    }
+
+    size_t regressions = 0;
+    if (!options.baseline.empty() || options.max_ratio > 0) {
+        regressions = check_regressions(results, baseline, options);
+        std::printf("%zu regression(s)\n", regressions);
+    }
+    return regressions ? 1 : 0;
+}
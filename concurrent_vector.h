@@ -0,0 +1,245 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Append-only vector for many producer threads.
+//
+// push_back/emplace_back/grow_by reserve their indices with one atomic fetch_add and construct into
+// segmented storage: segment k holds segment_base << k elements, so no segment ever moves once it has
+// been allocated and a reference to an element stays valid for the lifetime of the container.
+// Segments are allocated on first use by whichever thread claims them first; other threads that need
+// the same segment wait for it to be published instead of allocating their own. Every slot has a
+// ready flag that is set with release ordering once its element is constructed; published(i) lets a
+// reader on another thread check it, after which operator[](i) is safe to use concurrently with
+// further appends. An element whose constructor throws is never published and is skipped by freeze()
+// and the destructor.
+//
+// clear(), freeze() and destruction must not run concurrently with anything else.
+template <typename T>
+class ConcurrentVector {
+    static constexpr size_t segment_count = 64;
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+    static constexpr size_t segment_base = std::max<size_t>(16, 4096 / sizeof(T));
+
+    ConcurrentVector() noexcept = default;
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    ~ConcurrentVector() {
+        clear();
+    }
+
+    template <typename... Args>
+    size_t emplace_back(Args&&... args) {
+        size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+        constructAt(index, std::forward<Args>(args)...);
+        return index;
+    }
+
+    size_t push_back(const T& value) {
+        return emplace_back(value);
+    }
+
+    size_t push_back(T&& value) {
+        return emplace_back(std::move(value));
+    }
+
+    // Appends count copies of value at consecutive indices and returns the first of them.
+    size_t grow_by(size_t count, const T& value = T()) {
+        size_t first = size_.fetch_add(count, std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            constructAt(first + i, value);
+        }
+        return first;
+    }
+
+    // Allocates the segments needed for count elements ahead of time.
+    void reserve(size_t count) {
+        for (size_t k = 0; k < segment_count && segment_start(k) < count; ++k) {
+            segment(k);
+        }
+    }
+
+    // Number of reserved indices, including elements that are still being constructed.
+    [[nodiscard]] size_t size() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    // True once the element at index has been fully constructed; pairs with the producer's release.
+    [[nodiscard]] bool published(size_t index) const noexcept {
+        if (index >= size()) {
+            return false;
+        }
+        size_t k = segment_of(index);
+        T* items = segments_[k].load(std::memory_order_acquire);
+        return items && items != pending() && ready(items, k)[index - segment_start(k)].load(std::memory_order_acquire);
+    }
+
+    reference operator[](size_t index) noexcept {
+        size_t k = segment_of(index);
+        return segments_[k].load(std::memory_order_acquire)[index - segment_start(k)];
+    }
+
+    const_reference operator[](size_t index) const noexcept {
+        size_t k = segment_of(index);
+        return segments_[k].load(std::memory_order_acquire)[index - segment_start(k)];
+    }
+
+    reference at(size_t index) {
+        if (!published(index)) {
+            throw std::out_of_range("Index out of range");
+        }
+        return (*this)[index];
+    }
+
+    const_reference at(size_t index) const {
+        if (!published(index)) {
+            throw std::out_of_range("Index out of range");
+        }
+        return (*this)[index];
+    }
+
+    // Moves every published element, in index order, into one contiguous Vector and leaves this empty.
+    template <class V = Vector<T>>
+    V freeze() {
+        V result;
+        size_t n = size_.load(std::memory_order_acquire);
+        result.reserve(n);
+        for (size_t k = 0; k < segment_count && segment_start(k) < n; ++k) {
+            T* items = segments_[k].load(std::memory_order_acquire);
+            if (!items) {
+                continue;
+            }
+            size_t count = std::min(segment_size(k), n - segment_start(k));
+            std::atomic<uint8_t>* flags = ready(items, k);
+            for (size_t i = 0; i < count; ++i) {
+                if (flags[i].load(std::memory_order_relaxed)) {
+                    result.push_back(std::move(items[i]));
+                }
+            }
+        }
+        clear();
+        return result;
+    }
+
+    void clear() noexcept {
+        size_t n = size_.load(std::memory_order_acquire);
+        for (size_t k = 0; k < segment_count; ++k) {
+            T* items = segments_[k].exchange(nullptr, std::memory_order_acq_rel);
+            if (!items) {
+                continue;
+            }
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                size_t count = segment_start(k) < n ? std::min(segment_size(k), n - segment_start(k)) : 0;
+                std::atomic<uint8_t>* flags = ready(items, k);
+                for (size_t i = 0; i < count; ++i) {
+                    if (flags[i].load(std::memory_order_relaxed)) {
+                        std::destroy_at(items + i);
+                    }
+                }
+            }
+            releaseSegment(items, k);
+        }
+        size_.store(0, std::memory_order_release);
+    }
+
+private:
+    static constexpr size_t segment_size(size_t k) noexcept {
+        return segment_base << k;
+    }
+
+    static constexpr size_t segment_start(size_t k) noexcept {
+        return segment_base * ((size_t(1) << k) - 1);
+    }
+
+    static constexpr size_t segment_of(size_t index) noexcept {
+        return static_cast<size_t>(std::bit_width(index / segment_base + 1)) - 1;
+    }
+
+    // The ready flags follow the elements in the same allocation.
+    static std::atomic<uint8_t>* ready(T* items, size_t k) noexcept {
+        return reinterpret_cast<std::atomic<uint8_t>*>(reinterpret_cast<char*>(items) + segment_size(k) * sizeof(T));
+    }
+
+    static size_t segment_bytes(size_t k) {
+        if (segment_size(k) > (SIZE_MAX / 2) / (sizeof(T) + 1)) {
+            throw std::length_error("ConcurrentVector size exceeds the addressable range");
+        }
+        return segment_size(k) * (sizeof(T) + 1);
+    }
+
+    static void releaseSegment(T* items, size_t k) noexcept {
+        std::destroy_n(ready(items, k), segment_size(k));
+        ::operator delete(static_cast<void*>(items), segment_size(k) * (sizeof(T) + 1), std::align_val_t(alignof(T)));
+    }
+
+    // Stands in for a segment whose allocation is in progress on another thread.
+    static T* pending() noexcept {
+        return reinterpret_cast<T*>(alignof(T));
+    }
+
+    T* segment(size_t k) {
+        T* items = segments_[k].load(std::memory_order_acquire);
+        if (items && items != pending()) {
+            return items;
+        }
+        size_t bytes = segment_bytes(k);
+        while (!items || items == pending()) {
+            if (items == pending()) {
+                segments_[k].wait(items, std::memory_order_acquire);
+                items = segments_[k].load(std::memory_order_acquire);
+            }
+            else if (segments_[k].compare_exchange_weak(items, pending(), std::memory_order_acquire)) {
+                T* fresh;
+                try {
+                    fresh = static_cast<T*>(::operator new(bytes, std::align_val_t(alignof(T))));
+                }
+                catch (...) {
+                    segments_[k].store(nullptr, std::memory_order_release);
+                    segments_[k].notify_all();
+                    throw;
+                }
+                std::uninitialized_value_construct_n(ready(fresh, k), segment_size(k));
+                segments_[k].store(fresh, std::memory_order_release);
+                segments_[k].notify_all();
+                return fresh;
+            }
+        }
+        return items;
+    }
+
+    template <typename... Args>
+    void constructAt(size_t index, Args&&... args) {
+        size_t k = segment_of(index);
+        T* items = segment(k);
+        size_t offset = index - segment_start(k);
+        ::new (static_cast<void*>(items + offset)) T(std::forward<Args>(args)...);
+        ready(items, k)[offset].store(1, std::memory_order_release);
+    }
+
+    std::atomic<T*> segments_[segment_count] = {};
+    std::atomic<size_t> size_{0};
+};
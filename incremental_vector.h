@@ -0,0 +1,393 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Vector variant that spreads reallocation over the appends that follow it, so no single push_back
+// pays O(n) for the move into a bigger buffer.
+//
+// When the buffer is full, push_back allocates the new one, constructs the new element in it and from
+// then on every append relocates at least Step more of the old elements. Until that migration is done
+// element i lives in the new buffer when i < migrated_ or i >= oldSize_ and in the old buffer
+// otherwise, which costs operator[] one branch; the step grows when needed so that the migration always
+// ends before the new buffer fills up. The worst push_back is one allocation plus
+// max(Step, 1 / (growth factor - 1)) relocations.
+//
+// The elements are contiguous once no migration is pending. data(), reserve() and shrink_to_fit()
+// finish a pending migration first (in O(n)); iterators and operator[] work at any time.
+template <typename T, size_t Step = 16, class Alloc = std::allocator<T>, class GrowthPolicy = DefaultGrowth>
+class IncrementalVector {
+    static_assert(Step > 0, "Step must be positive");
+    static_assert(std::is_nothrow_move_constructible_v<T>, "IncrementalVector requires nothrow move construction");
+    static_assert(growth_policy<GrowthPolicy>, "GrowthPolicy must provide static next_capacity(capacity, required, elementSize)");
+
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+    static constexpr size_t step = Step;
+
+    IncrementalVector() noexcept(std::is_nothrow_default_constructible_v<Alloc>) = default;
+
+    explicit IncrementalVector(const Alloc& allocator) noexcept : alloc_(allocator) {}
+
+    IncrementalVector(std::initializer_list<T> values) {
+        reserve(values.size());
+        for (const T& value : values) {
+            push_back(value);
+        }
+    }
+
+    IncrementalVector(const IncrementalVector& other)
+        : alloc_(AllocTraits::select_on_container_copy_construction(other.alloc_)) {
+        reserve(other.size_);
+        for (size_t i = 0; i < other.size_; ++i) {
+            push_back(other[i]);
+        }
+    }
+
+    IncrementalVector(IncrementalVector&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)),
+          capacity_(std::exchange(other.capacity_, 0)), old_(std::exchange(other.old_, nullptr)),
+          oldCapacity_(std::exchange(other.oldCapacity_, 0)), oldSize_(std::exchange(other.oldSize_, 0)),
+          migrated_(std::exchange(other.migrated_, 0)), alloc_(std::move(other.alloc_)) {}
+
+    IncrementalVector& operator=(IncrementalVector other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~IncrementalVector() {
+        clear();
+        if (data_) {
+            AllocTraits::deallocate(alloc_, data_, capacity_);
+        }
+    }
+
+    void swap(IncrementalVector& other) noexcept {
+        using std::swap;
+        swap(data_, other.data_);
+        swap(size_, other.size_);
+        swap(capacity_, other.capacity_);
+        swap(old_, other.old_);
+        swap(oldCapacity_, other.oldCapacity_);
+        swap(oldSize_, other.oldSize_);
+        swap(migrated_, other.migrated_);
+        swap(alloc_, other.alloc_);
+    }
+
+    template <bool isConst>
+    class baseIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<isConst, const T*, T*>;
+        using reference = std::conditional_t<isConst, const T&, T&>;
+
+    private:
+        template <bool>
+        friend class baseIterator;
+
+        using Owner = std::conditional_t<isConst, const IncrementalVector, IncrementalVector>;
+
+        Owner* owner;
+        size_t index;
+
+    public:
+        template <bool OtherIsConst, typename = std::enable_if_t<isConst && !OtherIsConst>>
+        baseIterator(const baseIterator<OtherIsConst>& other) noexcept : owner(other.owner), index(other.index) {}
+        baseIterator(Owner* o = nullptr, size_t i = 0) noexcept : owner(o), index(i) {}
+
+        reference operator*() const noexcept { return (*owner)[index]; }
+        pointer operator->() const noexcept { return &(*owner)[index]; }
+        reference operator[](difference_type n) const noexcept { return (*owner)[index + static_cast<size_t>(n)]; }
+
+        baseIterator& operator++() noexcept {
+            ++index;
+            return *this;
+        }
+
+        baseIterator operator++(int) noexcept {
+            baseIterator tmp(*this);
+            ++index;
+            return tmp;
+        }
+
+        baseIterator& operator--() noexcept {
+            --index;
+            return *this;
+        }
+
+        baseIterator operator--(int) noexcept {
+            baseIterator tmp(*this);
+            --index;
+            return tmp;
+        }
+
+        baseIterator& operator+=(difference_type n) noexcept {
+            index += static_cast<size_t>(n);
+            return *this;
+        }
+
+        baseIterator operator+(difference_type n) const noexcept {
+            baseIterator tmp(*this);
+            tmp += n;
+            return tmp;
+        }
+
+        friend baseIterator operator+(difference_type n, const baseIterator& it) noexcept {
+            return it + n;
+        }
+
+        baseIterator& operator-=(difference_type n) noexcept {
+            index -= static_cast<size_t>(n);
+            return *this;
+        }
+
+        baseIterator operator-(difference_type n) const noexcept {
+            baseIterator tmp(*this);
+            tmp -= n;
+            return tmp;
+        }
+
+        difference_type operator-(const baseIterator& other) const noexcept {
+            return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+        }
+
+        bool operator==(const baseIterator& other) const noexcept {
+            return index == other.index;
+        }
+
+        auto operator<=>(const baseIterator& other) const noexcept {
+            return index <=> other.index;
+        }
+    };
+
+    using Iterator = baseIterator<false>;
+    using ConstIterator = baseIterator<true>;
+
+    Iterator begin() noexcept { return Iterator(this, 0); }
+    Iterator end() noexcept { return Iterator(this, size_); }
+    ConstIterator begin() const noexcept { return ConstIterator(this, 0); }
+    ConstIterator end() const noexcept { return ConstIterator(this, size_); }
+    ConstIterator cbegin() const noexcept { return begin(); }
+    ConstIterator cend() const noexcept { return end(); }
+
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] Alloc get_allocator() const noexcept { return alloc_; }
+
+    // True while part of the elements still sit in the previous buffer.
+    [[nodiscard]] bool migrating() const noexcept { return old_ != nullptr; }
+
+    reference operator[](size_t index) noexcept { return *slot(index); }
+    const_reference operator[](size_t index) const noexcept { return *slot(index); }
+
+    reference at(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return *slot(index);
+    }
+
+    const_reference at(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return *slot(index);
+    }
+
+    reference front() { return at(0); }
+    const_reference front() const { return at(0); }
+    reference back() { return at(size_ - 1); }
+    const_reference back() const { return at(size_ - 1); }
+
+    // Contiguous view of the elements; finishes a pending migration.
+    [[nodiscard]] T* data() noexcept {
+        finish_migration();
+        return data_;
+    }
+
+    void finish_migration() noexcept {
+        if (old_) {
+            migrate(oldSize_ - migrated_);
+        }
+    }
+
+    void reserve(size_t newCapacity) {
+        finish_migration();
+        if (newCapacity > capacity_) {
+            reallocate(newCapacity);
+        }
+    }
+
+    void shrink_to_fit() {
+        finish_migration();
+        if (size_ < capacity_) {
+            reallocate(size_);
+        }
+    }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (size_ == capacity_) {
+            // the element is built in the new buffer before any migration, so args may alias an element
+            startGrowth(std::forward<Args>(args)...);
+        }
+        else {
+            AllocTraits::construct(alloc_, data_ + size_, std::forward<Args>(args)...);
+            ++size_;
+        }
+        T& added = data_[size_ - 1];
+        if (old_) {
+            migrateStep();
+        }
+        return added;
+    }
+
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    void pop_back() {
+        if (empty()) {
+            throw std::out_of_range("Vector is empty");
+        }
+        AllocTraits::destroy(alloc_, slot(size_ - 1));
+        --size_;
+        if (old_ && size_ < oldSize_) {
+            oldSize_ = size_;
+            migrated_ = std::min(migrated_, oldSize_);
+            if (migrated_ == oldSize_) {
+                releaseOld();
+            }
+        }
+    }
+
+    void clear() noexcept {
+        for (size_t i = 0; i < size_; ++i) {
+            AllocTraits::destroy(alloc_, slot(i));
+        }
+        size_ = 0;
+        if (old_) {
+            releaseOld();
+        }
+    }
+
+private:
+    T* slot(size_t index) const noexcept {
+        return old_ && index >= migrated_ && index < oldSize_ ? old_ + index : data_ + index;
+    }
+
+    template <typename... Args>
+    void startGrowth(Args&&... args) {
+        finish_migration();
+        size_t newCapacity = std::max(GrowthPolicy::next_capacity(capacity_, size_ + 1, sizeof(T)), size_ + 1);
+        T* fresh = AllocTraits::allocate(alloc_, newCapacity);
+        try {
+            AllocTraits::construct(alloc_, fresh + size_, std::forward<Args>(args)...);
+        }
+        catch (...) {
+            AllocTraits::deallocate(alloc_, fresh, newCapacity);
+            throw;
+        }
+        if (size_ > 0) {
+            old_ = data_;
+            oldCapacity_ = capacity_;
+            oldSize_ = size_;
+            migrated_ = 0;
+        }
+        else if (data_) {
+            AllocTraits::deallocate(alloc_, data_, capacity_);
+        }
+        data_ = fresh;
+        capacity_ = newCapacity;
+        ++size_;
+    }
+
+    // Relocates enough elements that the migration ends before the new buffer is full.
+    void migrateStep() noexcept {
+        size_t remaining = oldSize_ - migrated_;
+        size_t appendsLeft = capacity_ - size_ + 1;
+        migrate(std::min(remaining, std::max(Step, (remaining + appendsLeft - 1) / appendsLeft)));
+    }
+
+    void migrate(size_t count) noexcept {
+        T* src = old_ + migrated_;
+        T* dest = data_ + migrated_;
+        if constexpr (is_trivially_relocatable_v<T>) {
+            std::memcpy(static_cast<void*>(dest), static_cast<const void*>(src), count * sizeof(T));
+        }
+        else {
+            for (size_t i = 0; i < count; ++i) {
+                AllocTraits::construct(alloc_, dest + i, std::move(src[i]));
+                AllocTraits::destroy(alloc_, src + i);
+            }
+        }
+        migrated_ += count;
+        if (migrated_ == oldSize_) {
+            releaseOld();
+        }
+    }
+
+    void releaseOld() noexcept {
+        AllocTraits::deallocate(alloc_, old_, oldCapacity_);
+        old_ = nullptr;
+        oldCapacity_ = 0;
+        oldSize_ = 0;
+        migrated_ = 0;
+    }
+
+    // Exact-capacity reallocation in one go, for reserve and shrink_to_fit.
+    void reallocate(size_t newCapacity) {
+        T* fresh = newCapacity ? AllocTraits::allocate(alloc_, newCapacity) : nullptr;
+        if (data_) {
+            old_ = data_;
+            oldCapacity_ = capacity_;
+            oldSize_ = size_;
+            migrated_ = 0;
+            data_ = fresh;
+            capacity_ = newCapacity;
+            if (size_ > 0) {
+                migrate(size_);
+            }
+            else {
+                releaseOld();
+            }
+        }
+        else {
+            data_ = fresh;
+            capacity_ = newCapacity;
+        }
+    }
+
+    T* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    T* old_ = nullptr;
+    size_t oldCapacity_ = 0;
+    size_t oldSize_ = 0;
+    size_t migrated_ = 0;
+    [[no_unique_address]] Alloc alloc_;
+};
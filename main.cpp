@@ -1,14 +1,37 @@
+// The precondition checks stay on in NDEBUG builds so that test_checked_mode can exercise them.
+#ifndef VECTOR_CHECK_LEVEL
+#define VECTOR_CHECK_LEVEL VECTOR_CHECK_ASSERT
+#endif
+
 #include "vector.h"
+#include "parallel.h"
+#include "static_vector.h"
+#include "mapped_vector.h"
+#include "concurrent_vector.h"
+#include "serialization.h"
+#include "incremental_vector.h"
+#include "segmented_vector.h"
+#include "soa_vector.h"
+#include "numa.h"
+#include "allocators.h"
+#include "vector_ops.h"
 #include <vector>
 #include <iostream>
-#include <chrono>
 #include <cassert>
 #include <string>
 #include <random>
 #include <algorithm>
+#include <numeric>
+#include <memory_resource>
+#include <cmath>
+#include <filesystem>
+#include <thread>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
 
 using namespace std;
-using namespace chrono;
 
 template<typename T>
 void print_test_result(const string& test_name, T expected, T actual) {
@@ -20,15 +43,32 @@ void print_test_result(const string& test_name, T expected, T actual) {
     }
 }
 
-class Timer {
-    high_resolution_clock::time_point start;
-public:
-    Timer() : start(high_resolution_clock::now()) {}
-    double elapsed() const {
-        auto end = high_resolution_clock::now();
-        return duration_cast<microseconds>(end - start).count() / 1000.0;
+// CRC-32 lookup table built with push_back at compile time
+constexpr auto build_crc_table = [] {
+    Vector<uint32_t> table;
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = crc & 1 ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+        }
+        table.push_back(crc);
     }
+    return table;
 };
+constexpr auto crc_table = to_static_array<build_crc_table>();
+
+// Sum of one column of a row-major 4x3 matrix, plus where 5 sits in a slice, computed at compile time
+constexpr int column_sum_and_index() {
+    Vector<int> matrix;
+    for (int i = 0; i < 12; ++i) {
+        matrix.push_back(i);
+    }
+    int sum = 0;
+    for (int x : matrix.strided(1, 3)) {
+        sum += x;
+    }
+    return sum * 10 + static_cast<int>(matrix.slice(2, 4).index(5));
+}
 
 void test_functionality() {
     cout << "\n=== Functionality Tests ===\n";
@@ -43,11 +83,11 @@ void test_functionality() {
     }
 
     // Test size and capacity
-    print_test_result("Size test", std_vec.size(), custom_vec.getSize());
+    print_test_result("Size test", std_vec.size(), custom_vec.size());
 
     // Test element access
     bool access_test = true;
-    for(size_t i = 0; i < custom_vec.getSize(); ++i) {
+    for(size_t i = 0; i < custom_vec.size(); ++i) {
         if(custom_vec[i] != std_vec[i]) {
             access_test = false;
             break;
@@ -60,11 +100,11 @@ void test_functionality() {
         custom_vec.pop_back();
         std_vec.pop_back();
     }
-    print_test_result("Pop back test", std_vec.size(), custom_vec.getSize());
+    print_test_result("Pop back test", std_vec.size(), custom_vec.size());
 
     // Test element values after pop_back
     access_test = true;
-    for(size_t i = 0; i < custom_vec.getSize(); ++i) {
+    for(size_t i = 0; i < custom_vec.size(); ++i) {
         if(custom_vec[i] != std_vec[i]) {
             access_test = false;
             break;
@@ -72,140 +112,1002 @@ void test_functionality() {
     }
     cout << "Element values after pop_back: " << (access_test ? "PASSED" : "FAILED") << endl;
 
+    // Test erase_if against the erase-remove idiom
+    size_t removed = custom_vec.erase_if([](int x) { return x % 2 == 0; });
+    std_vec.erase(remove_if(std_vec.begin(), std_vec.end(), [](int x) { return x % 2 == 0; }), std_vec.end());
+    print_test_result("Erase if test", std_vec.size(), custom_vec.size());
+    print_test_result("Erase if count test", size_t(3), removed);
+
+    // Test unordered_erase moves the last element into the hole
+    int last = custom_vec.back();
+    custom_vec.unordered_erase(0);
+    print_test_result("Unordered erase test", last, custom_vec[0]);
+    std_vec.erase(std_vec.begin());
+
+    // Test slice views the elements in place
+    VectorView<int> head = custom_vec.slice(0, 1);
+    print_test_result("Slice test", custom_vec.data(), &head[0]);
+
+    // Test strided walks one column of a row-major 4x3 matrix
+    static_assert(random_access_iterator<StridedView<int>::Iterator>);
+    Vector<int> matrix(size_t(12));
+    iota(matrix.begin(), matrix.end(), 0);
+    StridedView<int> column = matrix.strided(1, 3);
+    const int expected_column[] = {1, 4, 7, 10};
+    print_test_result("Strided view test", true, ranges::equal(column, expected_column));
+    print_test_result("Strided distance test", ptrdiff_t(4), column.end() - column.begin());
+
+    // Test release and adopt hand the buffer over without copying
+    int* buffer = custom_vec.data();
+    VectorBuffer<int> released = custom_vec.release();
+    custom_vec = Vector<int>::adopt(released.data, released.size, released.capacity);
+    print_test_result("Release adopt test", buffer, custom_vec.data());
+
+    // Test instrumentation counts the copies of the initializer list and the copy constructor
+    InstrumentedVector<int, "functionality"> counted{1, 2, 3};
+    InstrumentedVector<int, "functionality"> counted_copy(counted);
+    uint64_t copied = 0;
+    vector_stats::for_each([&](const vector_stats::snapshot& s) {
+        if (s.site == "functionality") {
+            copied = s.elements_copied;
+        }
+    });
+    print_test_result("Instrumentation copy count test", uint64_t(6), copied);
+
+    // Test the compile-time table matches the well-known CRC-32 constants
+    static_assert(crc_table.size() == 256);
+    print_test_result("Constexpr table test", 0x2D02EF8Du, crc_table[255]);
+    static_assert(column_sum_and_index() == 223);
+    print_test_result("Constexpr views test", 223, column_sum_and_index());
+
+    // Test append_range and insert_range with a source inside the vector being grown
+    Vector<string> words{"alpha", "beta", "gamma"};
+    words.shrink_to_fit();
+    words.append_range(span<const string>(words.data(), 2));
+    print_test_result("Append range aliasing test", string("beta"), words[4]);
+    words.append_range(words);
+    print_test_result("Append self test", string("alpha"), words[5]);
+
+    Vector<int> digits{1, 2, 3, 4};
+    digits.reserve(16);
+    digits.insert_range(size_t(0), span<const int>(digits.data() + 2, 2));
+    const int expected_digits[] = {3, 4, 1, 2, 3, 4};
+    print_test_result("Insert range aliasing test", true, ranges::equal(digits, expected_digits));
+
+    // Test insert, resize and assign with a value that lives in the buffer being replaced
+    Vector<string> grown{"x", string(30, 'y')};
+    grown.shrink_to_fit();
+    grown.insert(grown[1], size_t(0));
+    print_test_result("Insert aliasing test", string(30, 'y'), grown[0]);
+    grown.resize(10, grown[1]);
+    print_test_result("Resize value aliasing test", string("x"), grown[9]);
+    grown.assign(size_t(20), grown[2]);
+    print_test_result("Assign value aliasing test", true, grown.size() == 20 && ranges::all_of(grown, [](const string& x) { return x == string(30, 'y'); }));
+
     // Test clear
     custom_vec.clear();
     std_vec.clear();
-    print_test_result("Clear test", std_vec.size(), custom_vec.getSize());
+    print_test_result("Clear test", std_vec.size(), custom_vec.size());
+}
+
+void test_small_vector() {
+    cout << "\n=== SmallVector Tests ===\n";
+
+    SmallVector<string, 4> small;
+    for (int i = 0; i < 3; ++i) {
+        small.push_back(to_string(i));
+    }
+    print_test_result("Inline capacity test", size_t(4), small.capacity());
+
+    for (int i = 3; i < 10; ++i) {
+        small.push_back(to_string(i));
+    }
+    print_test_result("Spill size test", size_t(10), small.size());
+    print_test_result("Spill element test", string("9"), small.back());
+
+    small.erase(small.begin() + 2, small.end());
+    small.shrink_to_fit();
+    print_test_result("Shrink back to inline test", size_t(4), small.capacity());
+
+    SmallVector<string, 4> moved(std::move(small));
+    print_test_result("Inline move test", string("1"), moved[1]);
+
+    // Test swap and copy assignment between an inline and a spilled SmallVector
+    SmallVector<string, 4> spilled;
+    for (int i = 0; i < 8; ++i) {
+        spilled.push_back(to_string(i * 10));
+    }
+    moved.swap(spilled);
+    print_test_result("Inline swap test", true, moved.size() == 8 && moved[7] == "70" && spilled.size() == 2 && spilled[1] == "1");
+    spilled = moved;
+    print_test_result("Spilled copy assign test", true, ranges::equal(spilled, moved));
+    moved = SmallVector<string, 4>{"x"};
+    print_test_result("Move assign inline test", string("x"), moved[0]);
 }
 
-void test_performance() {
-    cout << "\n=== Performance Tests ===\n";
-    const int N = 1000000;
+void test_static_vector() {
+    cout << "\n=== StaticVector Tests ===\n";
+
+    static_assert(is_trivially_copyable_v<StaticVector<int, 4>>);
+
+    StaticVector<int, 4> fixed{1, 2, 3};
+    print_test_result("Try push back test", true, fixed.try_push_back(4) != nullptr);
+    print_test_result("Try push back full test", true, fixed.try_push_back(5) == nullptr);
+
+    bool overflow = false;
+    try {
+        fixed.push_back(5);
+    } catch (const length_error&) {
+        overflow = true;
+    }
+    print_test_result("Overflow test", true, overflow);
+
+    fixed.erase(fixed.begin());
+    fixed.insert(9, size_t(1));
+    print_test_result("Static insert test", 9, fixed[1]);
+    print_test_result("Static size test", size_t(4), fixed.size());
 
-    // Test push_back performance
+    // Test reverse iteration of a full and an empty StaticVector
+    const int reversed[] = {4, 3, 9, 2};
+    print_test_result("Static reverse test", true, equal(fixed.rbegin(), fixed.rend(), begin(reversed), end(reversed)));
+    StaticVector<int, 4> none;
+    print_test_result("Static empty reverse test", true, none.rbegin() == none.rend() && as_const(none).crbegin() == none.crend());
+}
+
+void test_parallel() {
+    cout << "\n=== Parallel Tests ===\n";
+
+    static_assert(contiguous_iterator<Vector<int>::Iterator>);
+    static_assert(contiguous_iterator<Vector<int>::ConstIterator>);
+
+    parallel::ThreadPool pool(4);
+    parallel::par_options options{.chunk_size = 1000, .pool = &pool};
+
+    Vector<int> custom_vec;
+    std::vector<int> std_vec;
+    mt19937 gen(42);
+    for (int i = 0; i < 100000; ++i) {
+        int value = static_cast<int>(gen() % 100000);
+        custom_vec.push_back(value);
+        std_vec.push_back(value);
+    }
+
+    parallel::par_sort(custom_vec, less<>{}, options);
+    sort(std_vec.begin(), std_vec.end());
+    print_test_result("Parallel sort test", true, equal(custom_vec.begin(), custom_vec.end(), std_vec.begin()));
+
+    long long sum = parallel::par_reduce(custom_vec, 0LL, plus<>{}, options);
+    print_test_result("Parallel reduce test", accumulate(std_vec.begin(), std_vec.end(), 0LL), sum);
+
+    bool rejected = false;
+    try {
+        pool.run(parallel::ThreadPool::max_chunks + 1, [](size_t) {});
+    } catch (const length_error&) {
+        rejected = true;
+    }
+    print_test_result("Chunk count limit test", true, rejected);
+}
+
+void test_mapped_vector() {
+    cout << "\n=== MappedVector Tests ===\n";
+
+    string path = (filesystem::temp_directory_path() / "vector_main_test.map").string();
     {
-        Vector<int> custom_vec;
-        Timer custom_timer;
-        for (int i = 0; i < N; ++i) {
-            custom_vec.push_back(i);
+        MappedVector<int> mapped(path.c_str(), MappedVector<int>::open_mode::truncate);
+        while (mapped.size() < mapped.capacity()) {
+            mapped.push_back(static_cast<int>(mapped.size()));
         }
-        double custom_time = custom_timer.elapsed();
+        // both sources point into the mapping that is about to move
+        mapped.push_back(mapped[1]);
+        mapped.append(span<const int>(mapped.data(), 2));
 
-        std::vector<int> std_vec;
-        Timer std_timer;
-        for (int i = 0; i < N; ++i) {
-            std_vec.push_back(i);
+        // Test a reserve whose byte length would wrap is rejected without shortening the file
+        size_t before_size = mapped.size();
+        size_t before_capacity = mapped.capacity();
+        bool wrap_rejected = false;
+        try {
+            mapped.reserve(SIZE_MAX / sizeof(int) + 1);
+        } catch (const length_error&) {
+            wrap_rejected = true;
         }
-        double std_time = std_timer.elapsed();
+        print_test_result("Mapped reserve overflow test", true, wrap_rejected && mapped.size() == before_size
+            && mapped.capacity() == before_capacity && filesystem::file_size(path) >= before_capacity * sizeof(int));
+        mapped.sync();
 
-        cout << "Push back " << N << " elements:\n";
-        cout << "Custom vector: " << custom_time << "ms\n";
-        cout << "STD vector: " << std_time << "ms\n";
-        cout << "Ratio (custom/std): " << custom_time/std_time << "\n";
+        MappedVector<int> moved(std::move(mapped));
+        print_test_result("Moved-from mapped size test", size_t(0), mapped.size());
     }
 
-    // Test pop_back performance
-    {
-        Vector<int> custom_vec;
-        std::vector<int> std_vec;
+    MappedVector<int> reopened(path.c_str());
+    size_t filled = reopened.size() - 3;
+    bool contents = true;
+    for (size_t i = 0; i < filled; ++i) {
+        contents = contents && reopened[i] == static_cast<int>(i);
+    }
+    print_test_result("Reopen contents test", true, contents);
+    print_test_result("Aliasing push back test", 1, reopened[filled]);
+    print_test_result("Aliasing append test", 1, reopened.back());
 
-        // Fill vectors
-        for (int i = 0; i < N; ++i) {
-            custom_vec.push_back(i);
-            std_vec.push_back(i);
-        }
+    MappedView<int> view(path.c_str());
+    print_test_result("Mapped view size test", reopened.size(), view.size());
+    print_test_result("Mapped view contents test", true, equal(view.begin(), view.end(), reopened.begin()));
 
-        Timer custom_timer;
-        for (int i = 0; i < N; ++i) {
-            custom_vec.pop_back();
-        }
-        double custom_time = custom_timer.elapsed();
+    filesystem::remove(path);
+}
+
+void test_concurrent_vector() {
+    cout << "\n=== ConcurrentVector Tests ===\n";
+
+    constexpr int producers = 4;
+    constexpr int per_producer = 50000;
+    ConcurrentVector<int> shared;
 
-        Timer std_timer;
-        for (int i = 0; i < N; ++i) {
-            std_vec.pop_back();
+    // the reader checks that every published slot already holds a value some producer wrote
+    atomic<bool> done{false};
+    bool reads_valid = true;
+    thread reader([&] {
+        while (!done.load()) {
+            size_t n = shared.size();
+            for (size_t i = 0; i < n; i += 97) {
+                if (shared.published(i) && (shared[i] < 0 || shared[i] >= producers * per_producer)) {
+                    reads_valid = false;
+                }
+            }
         }
-        double std_time = std_timer.elapsed();
+    });
 
-        cout << "\nPop back " << N << " elements:\n";
-        cout << "Custom vector: " << custom_time << "ms\n";
-        cout << "STD vector: " << std_time << "ms\n";
-        cout << "Ratio (custom/std): " << custom_time/std_time << "\n";
+    vector<thread> threads;
+    for (int t = 0; t < producers; ++t) {
+        threads.emplace_back([&shared, t] {
+            for (int i = 0; i < per_producer; ++i) {
+                shared.push_back(t * per_producer + i);
+            }
+        });
     }
+    for (thread& t : threads) {
+        t.join();
+    }
+    done = true;
+    reader.join();
 
-    // Test random access performance
-    {
-        Vector<int> custom_vec;
-        std::vector<int> std_vec;
+    print_test_result("Concurrent size test", size_t(producers * per_producer), shared.size());
+    print_test_result("Concurrent read test", true, reads_valid);
 
-        for (int i = 0; i < N; ++i) {
-            custom_vec.push_back(i);
-            std_vec.push_back(i);
-        }
+    Vector<int> frozen = shared.freeze();
+    sort(frozen.begin(), frozen.end());
+    bool all_present = true;
+    for (size_t i = 0; i < frozen.size(); ++i) {
+        all_present = all_present && frozen[i] == static_cast<int>(i);
+    }
+    print_test_result("Concurrent freeze test", true, all_present && frozen.size() == size_t(producers * per_producer));
+    print_test_result("Frozen source empty test", true, shared.empty());
+}
+
+// Reads bytes back into a Vector<T> and reports whether vector_io rejected them as corrupt.
+template <typename T>
+bool rejects(const string& bytes) {
+    istringstream in(bytes);
+    Vector<T> target{T(7)};
+    try {
+        vector_io::read_from(in, target);
+    } catch (const runtime_error&) {
+        return target.size() == 1 && target[0] == T(7);
+    }
+    return false;
+}
+
+void test_serialization() {
+    cout << "\n=== Serialization Tests ===\n";
+
+    Vector<int> numbers;
+    for (int i = 0; i < 1000; ++i) {
+        numbers.push_back(i * i);
+    }
+    ostringstream out;
+    vector_io::write_to(out, numbers);
+    string bytes = out.str();
+
+    istringstream in(bytes);
+    Vector<int> loaded;
+    vector_io::read_from(in, loaded);
+    print_test_result("Stream round trip test", true, ranges::equal(numbers, loaded));
+
+    ostringstream empty_out;
+    vector_io::write_to(empty_out, Vector<int>());
+    istringstream empty_in(empty_out.str());
+    Vector<int> empty_loaded{1, 2, 3};
+    vector_io::read_from(empty_in, empty_loaded);
+    print_test_result("Empty round trip test", size_t(0), empty_loaded.size());
+
+    string path = (filesystem::temp_directory_path() / "vector_main_test.bin").string();
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    vector_io::write_to(fd, numbers);
+    ::lseek(fd, 0, SEEK_SET);
+    Vector<int> from_file;
+    vector_io::read_from(fd, from_file);
+    ::close(fd);
+    filesystem::remove(path);
+    print_test_result("File round trip test", true, ranges::equal(numbers, from_file));
+
+    Vector<string> words{"serialized", "", "strings"};
+    ostringstream words_out;
+    vector_io::write_to(words_out, words);
+    istringstream words_in(words_out.str());
+    Vector<string> words_loaded;
+    vector_io::read_from(words_in, words_loaded);
+    print_test_result("String round trip test", true, ranges::equal(words, words_loaded));
+
+    // the 24-byte header is followed by the payload
+    string flipped = bytes;
+    flipped[24 + 100] ^= 0x01;
+    print_test_result("Flipped payload byte test", true, rejects<int>(flipped));
+    print_test_result("Truncated trailer test", true, rejects<int>(bytes.substr(0, bytes.size() - 4)));
+    print_test_result("Wrong element size test", true, rejects<int64_t>(bytes));
+
+#if defined(VECTOR_IO_LZ4)
+    ostringstream packed_out;
+    vector_io::write_to(packed_out, numbers, {.codec = vector_io::compression::lz4, .block_size = 1024});
+    istringstream packed_in(packed_out.str());
+    Vector<int> unpacked;
+    vector_io::read_from(packed_in, unpacked);
+    print_test_result("LZ4 round trip test", true, ranges::equal(numbers, unpacked));
+#endif
+}
+
+// Fills an IncrementalVector up to its capacity and then one past it, which starts a migration.
+template <class V>
+void push_past_capacity(V& v, vector<string>& expected) {
+    do {
+        expected.push_back("element " + to_string(expected.size()));
+        v.push_back(expected.back());
+    } while (!v.migrating());
+}
+
+void test_incremental_vector() {
+    cout << "\n=== IncrementalVector Tests ===\n";
 
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(0, N-1);
+    // a step of 1 keeps the migration pending for as many appends as possible
+    using Incremental = IncrementalVector<string, 1>;
 
-        Timer custom_timer;
-        volatile int sum = 0;
-        for (int i = 0; i < N; ++i) {
-            sum += custom_vec[dis(gen)];
+    Incremental growing;
+    growing.reserve(64);
+    vector<string> expected;
+    push_past_capacity(growing, expected);
+    for (int i = 0; i < 2; ++i) {
+        expected.push_back("while migrating " + to_string(i));
+        growing.push_back(expected.back());
+    }
+    bool indexed = true;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        indexed = indexed && growing[i] == expected[i];
+    }
+    print_test_result("Migrating index test", true, indexed && growing.migrating());
+    print_test_result("Migrating iteration test", true, equal(growing.begin(), growing.end(), expected.begin(), expected.end()));
+
+    Incremental copy(growing);
+    print_test_result("Migrating copy test", true, equal(copy.begin(), copy.end(), expected.begin(), expected.end()));
+
+    // popping into the part that has not been moved yet shortens the old buffer
+    size_t keep = expected.size() - 10;
+    while (growing.size() > keep) {
+        growing.pop_back();
+        expected.pop_back();
+    }
+    print_test_result("Pop keeps migrating test", true, growing.migrating());
+    growing.push_back("after pop");
+    expected.push_back("after pop");
+    print_test_result("Pop below old size test", true, equal(growing.begin(), growing.end(), expected.begin(), expected.end()));
+
+    Incremental reserved;
+    vector<string> reserved_expected;
+    push_past_capacity(reserved, reserved_expected);
+    reserved.reserve(reserved.capacity() + 1);
+    print_test_result("Reserve finishes migration test", false, reserved.migrating());
+
+    Incremental contiguous;
+    vector<string> contiguous_expected;
+    push_past_capacity(contiguous, contiguous_expected);
+    string* first = contiguous.data();
+    print_test_result("Data finishes migration test", false, contiguous.migrating());
+    print_test_result("Data contents test", true, equal(first, first + contiguous.size(), contiguous_expected.begin(), contiguous_expected.end()));
+}
+
+void test_segmented_vector() {
+    cout << "\n=== SegmentedVector Tests ===\n";
+
+    // four elements per chunk, so every edit below moves elements across chunk boundaries
+    SegmentedVector<string, 4> segmented;
+    vector<string> expected;
+    for (int i = 0; i < 10; ++i) {
+        segmented.push_back(to_string(i));
+        expected.push_back(to_string(i));
+    }
+
+    segmented.insert("a", size_t(3));
+    expected.insert(expected.begin() + 3, "a");
+    segmented.insert("b", segmented.begin() + 8);
+    expected.insert(expected.begin() + 8, "b");
+    print_test_result("Segmented insert test", true, equal(segmented.begin(), segmented.end(), expected.begin(), expected.end()));
+
+    // Test insert takes (element, index) like Vector, so an integer element is not taken for the position
+    SegmentedVector<size_t, 4> positions;
+    Vector<size_t> same_positions;
+    for (size_t i = 0; i < 6; ++i) {
+        positions.push_back(i);
+        same_positions.push_back(i);
+    }
+    positions.insert(size_t(40), size_t(5));
+    same_positions.insert(size_t(40), size_t(5));
+    print_test_result("Segmented insert order test", true, equal(positions.begin(), positions.end(), same_positions.begin(), same_positions.end()));
+
+    segmented.erase(2, 7);
+    expected.erase(expected.begin() + 2, expected.begin() + 7);
+    print_test_result("Segmented erase test", true, equal(segmented.begin(), segmented.end(), expected.begin(), expected.end()));
+
+    segmented.resize(13, "r");
+    expected.resize(13, "r");
+    print_test_result("Segmented resize grow test", true, equal(segmented.begin(), segmented.end(), expected.begin(), expected.end()));
+    segmented.resize(5);
+    expected.resize(5);
+    print_test_result("Segmented resize shrink test", true, equal(segmented.begin(), segmented.end(), expected.begin(), expected.end()));
+
+    segmented.shrink_to_fit();
+    print_test_result("Segmented shrink to fit test", size_t(8), segmented.capacity());
+
+    Vector<string> copied = segmented.to_vector();
+    print_test_result("To vector copy test", true, ranges::equal(copied, expected) && segmented.size() == expected.size());
+    Vector<string> moved = std::move(segmented).to_vector();
+    print_test_result("To vector move test", true, ranges::equal(moved, expected) && segmented.empty());
+
+    parallel::ThreadPool pool(4);
+    SegmentedVector<int, 4> counters;
+    counters.resize(103);
+    parallel::par_for_each(counters, [](int& value) { ++value; }, {.pool = &pool});
+    print_test_result("Segmented par_for_each test", 103, accumulate(counters.begin(), counters.end(), 0));
+}
+
+struct Particle {
+    float x;
+    int id;
+    string name;
+};
+
+// Field whose default constructor throws while throw_on_default is set.
+struct DefaultThrows {
+    static inline bool throw_on_default = false;
+    int value = 0;
+
+    DefaultThrows() {
+        if (throw_on_default) {
+            throw runtime_error("default construction failed");
         }
-        double custom_time = custom_timer.elapsed();
+    }
+};
+
+// Field whose move assignment may throw.
+struct MoveMayThrow {
+    MoveMayThrow() = default;
+    MoveMayThrow(const MoveMayThrow&) = default;
+
+    MoveMayThrow& operator=(const MoveMayThrow&) {
+        return *this;
+    }
+};
+
+// Whether rows can be erased from S by index, in order or not.
+template <class S>
+concept row_erasable = requires(S rows) {
+    rows.erase(size_t(0));
+    rows.unordered_erase(size_t(0));
+};
+
+void test_soa_vector() {
+    cout << "\n=== SoAVector Tests ===\n";
+
+    SoAVector<float, int, string> particles;
+    particles.push_back(Particle{1.5f, 10, "a"});
+    particles.push_back(make_tuple(2.5f, 20, string("b")));
+    particles.emplace_back(3.5f, 30, "c");
+    particles.emplace_back(4.5f, 40, "d");
+    print_test_result("SoA size test", size_t(4), particles.size());
+
+    span<float> xs = particles.column<0>();
+    print_test_result("SoA column test", 12.0f, accumulate(xs.begin(), xs.end(), 0.0f));
+
+    auto [x, id, name] = particles[2];
+    id = 31;
+    print_test_result("SoA row reference test", 31, particles.column<1>()[2]);
+    print_test_result("SoA row value test", string("c"), get<2>(particles.row(2)));
+
+    particles.erase(1);
+    print_test_result("SoA erase test", string("c"), get<2>(particles[1]));
+    particles.unordered_erase(0);
+    print_test_result("SoA unordered erase test", 40, get<1>(particles[0]));
+    print_test_result("SoA erase size test", size_t(2), particles.size());
+    static_assert(row_erasable<SoAVector<float, int, string>>);
+    static_assert(!row_erasable<SoAVector<int, MoveMayThrow>>);
+
+    for (int i = 0; i < 1000; ++i) {
+        particles.emplace_back(static_cast<float>(i), i, to_string(i));
+    }
+    bool grown = particles.capacity() >= particles.size();
+    for (int i = 0; i < 1000; ++i) {
+        auto [gx, gid, gname] = particles[static_cast<size_t>(i) + 2];
+        grown = grown && gx == static_cast<float>(i) && gid == i && gname == to_string(i);
+    }
+    print_test_result("SoA growth test", true, grown);
+
+    // Test a row copied from the container itself survives the reallocation it triggers
+    get<2>(particles[0]) = string(40, 'q');
+    while (particles.size() < particles.capacity()) {
+        particles.emplace_back(0.0f, 0, "");
+    }
+    particles.push_back(particles[0]);
+    print_test_result("SoA self push back test", true, particles.row(particles.size() - 1) == particles.row(0));
+
+    // Test a resize that fails on a later column leaves every column at the old size
+    SoAVector<int, DefaultThrows> uneven;
+    uneven.resize(3);
+    DefaultThrows::throw_on_default = true;
+    bool resize_thrown = false;
+    try {
+        uneven.resize(10);
+    } catch (const runtime_error&) {
+        resize_thrown = true;
+    }
+    DefaultThrows::throw_on_default = false;
+    print_test_result("SoA resize rollback test", true, resize_thrown && uneven.size() == 3
+        && uneven.column<0>().size() == 3 && uneven.column<1>().size() == 3);
+}
+
+void test_numa() {
+    cout << "\n=== NUMA Tests ===\n";
+
+    // mbind is only a hint, so these run the same on a single-node machine
+    parallel::ThreadPool pool(4);
+    numa::numa_options options{.parallel = {.chunk_size = 4096, .pool = &pool}};
+    size_t count = size_t(1) << 20;
+
+    Vector<int> filled = numa::make_vector<Vector<int>>(count, 7, options);
+    print_test_result("NUMA make vector test", true, filled.size() == count && ranges::all_of(filled, [](int x) { return x == 7; }));
+
+    options.policy = numa::placement::bind;
+    Vector<int> zeroed = numa::make_vector<Vector<int>>(count, 0, options);
+    print_test_result("NUMA bind fill test", true, zeroed.size() == count && ranges::all_of(zeroed, [](int x) { return x == 0; }));
+
+    options.policy = numa::placement::interleave;
+    Vector<string> names = numa::make_vector<Vector<string>>(1000, "node", options);
+    print_test_result("NUMA non-trivial fill test", true, ranges::all_of(names, [](const string& x) { return x == "node"; }));
 
-        Timer std_timer;
-        sum = 0;
-        for (int i = 0; i < N; ++i) {
-            sum += std_vec[dis(gen)];
+    Vector<double> touched;
+    numa::reserve(touched, count, options);
+    print_test_result("NUMA reserve test", true, touched.capacity() >= count && touched.empty());
+    touched.resize(count);
+    print_test_result("NUMA value-initialized test", true, ranges::all_of(touched, [](double x) { return x == 0.0; }));
+}
+
+void test_huge_pages() {
+    cout << "\n=== HugePageAllocator Tests ===\n";
+
+    // a 64 KiB threshold crosses from malloc to mapped pages early; without reserved huge pages the
+    // allocator falls back to aligned regular pages
+    constexpr size_t page = size_t(2) << 20;
+    constexpr size_t threshold = size_t(64) << 10;
+    using HugeAlloc = HugePageAllocator<int, page, threshold>;
+
+    HugeAlloc alloc;
+    size_t n = page / sizeof(int);
+    int* block = alloc.allocate(n);
+    fill(block, block + n, 3);
+    print_test_result("Huge page alignment test", uintptr_t(0), reinterpret_cast<uintptr_t>(block) % page);
+    if (alloc.try_expand(block, n, 2 * n)) {
+        fill(block + n, block + 2 * n, 3);
+        n *= 2;
+    }
+    print_test_result("Huge page block test", true, all_of(block, block + n, [](int x) { return x == 3; }));
+    alloc.deallocate(block, n);
+
+    Vector<int, HugeAlloc, HugePageGrowth<DefaultGrowth, page, threshold>> huge;
+    for (int i = 0; i < (1 << 20); ++i) {
+        huge.push_back(i);
+    }
+    bool contents = true;
+    for (size_t i = 0; i < huge.size(); ++i) {
+        contents = contents && huge[i] == static_cast<int>(i);
+    }
+    print_test_result("Huge page grow test", true, contents);
+    print_test_result("Huge page capacity test", size_t(0), huge.capacity() * sizeof(int) % page);
+
+    huge.erase(size_t(1000), huge.size());
+    huge.shrink_to_fit();
+    print_test_result("Huge page shrink test", size_t(1000), huge.capacity());
+}
+
+// Runs fn in a child process and reports whether the child was killed by a signal.
+template <typename Fn>
+bool dies(Fn fn) {
+    cout.flush();
+    pid_t child = fork();
+    if (child == 0) {
+        freopen("/dev/null", "w", stderr);
+        fn();
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    return WIFSIGNALED(status);
+}
+
+void test_checked_mode() {
+    cout << "\n=== Checked Mode Tests ===\n";
+
+#if VECTOR_CHECK_LEVEL != VECTOR_CHECK_OFF
+    print_test_result("Pop back on empty test", true, dies([] {
+        Vector<int> empty;
+        empty.pop_back();
+    }));
+    print_test_result("Back on empty test", true, dies([] {
+        Vector<string> empty;
+        cout << empty.back();
+    }));
+    print_test_result("Index out of range test", true, dies([] {
+        Vector<int> small{1, 2, 3};
+        cout << small[3];
+    }));
+#endif
+
+    // Test an iterator taken before a push_back that fits the capacity still reaches the new element
+    Vector<int> reserved;
+    reserved.reserve(10);
+    reserved.push_back(1);
+    auto early = reserved.begin();
+    reserved.push_back(2);
+    StaticVector<int, 4> fixed;
+    fixed.push_back(1);
+    auto fixed_early = fixed.begin();
+    fixed.push_back(2);
+    print_test_result("Iterator after push back test", false, dies([&] {
+        cout << early[1] << *(early + 1) << fixed_early[1];
+    }));
+
+    bool thrown = false;
+    try {
+        (void)Vector<int>{1, 2, 3}.at(3);
+    } catch (const out_of_range&) {
+        thrown = true;
+    }
+    print_test_result("Checked at test", true, thrown);
+}
+
+// Capacities a Vector passes through while push_back fills it with count elements.
+template <class V>
+vector<size_t> capacity_sequence(size_t count) {
+    V v;
+    vector<size_t> capacities;
+    for (size_t i = 0; i < count; ++i) {
+        v.push_back(typename V::value_type());
+        if (capacities.empty() || capacities.back() != v.capacity()) {
+            capacities.push_back(v.capacity());
         }
-        double std_time = std_timer.elapsed();
+    }
+    return capacities;
+}
+
+// Number of allocate calls made through any CountingAllocator.
+size_t counted_allocations = 0;
+
+// std::allocator that counts its allocate calls.
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() noexcept = default;
 
-        cout << "\nRandom access " << N << " elements:\n";
-        cout << "Custom vector: " << custom_time << "ms\n";
-        cout << "STD vector: " << std_time << "ms\n";
-        cout << "Ratio (custom/std): " << custom_time/std_time << "\n";
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        ++counted_allocations;
+        return allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        allocator<T>().deallocate(p, n);
     }
 
-    // Test mixed operations performance
+    friend bool operator==(const CountingAllocator&, const CountingAllocator&) noexcept = default;
+};
+
+void test_vector_features() {
+    cout << "\n=== Vector Feature Tests ===\n";
+
+    // Test growth relocates unique_ptr bytewise and std::string by move, keeping every element
+    static_assert(is_trivially_relocatable_v<unique_ptr<int>>);
+    static_assert(!is_trivially_relocatable_v<string>);
+    Vector<unique_ptr<int>> owners;
+    for (int i = 0; i < 100; ++i) {
+        owners.push_back(make_unique<int>(i));
+    }
+    owners.reserve(300);
+    bool relocated = owners.capacity() == 300;
+    for (size_t i = 0; i < owners.size(); ++i) {
+        relocated = relocated && owners[i] && *owners[i] == static_cast<int>(i);
+    }
+    print_test_result("Relocating growth test", true, relocated);
+
+    Vector<string> long_strings;
+    for (int i = 0; i < 100; ++i) {
+        long_strings.push_back(string(40, static_cast<char>('a' + i % 26)));
+    }
+    long_strings.reserve(250);
+    print_test_result("Moving growth test", true, long_strings.size() == 100 && long_strings[99] == string(40, 'v'));
+
+    // Test growth through MallocAllocator's realloc/mremap keeps the contents
+    Vector<int, MallocAllocator<int>> reallocated;
+    for (int i = 0; i < (1 << 19); ++i) {
+        reallocated.push_back(i);
+    }
+    reallocated.push_back(reallocated[7]);
+    reallocated.erase(size_t(100), reallocated.size() - 1);
+    reallocated.shrink_to_fit();
+    bool realloc_contents = reallocated.capacity() == 101 && reallocated[100] == 7;
+    for (int i = 0; i < 100; ++i) {
+        realloc_contents = realloc_contents && reallocated[static_cast<size_t>(i)] == i;
+    }
+    print_test_result("Reallocate growth test", true, realloc_contents);
+
+    // Test the growth policies produce their documented capacity sequences
+    print_test_result("Default growth sequence test", true,
+        capacity_sequence<Vector<int>>(20) == vector<size_t>{1, 2, 3, 4, 6, 9, 13, 19, 28});
+    print_test_result("Doubling growth sequence test", true,
+        capacity_sequence<Vector<int, allocator<int>, DoublingGrowth>>(20) == vector<size_t>{1, 2, 4, 8, 16, 32});
+    print_test_result("Jemalloc growth sequence test", true,
+        capacity_sequence<Vector<int, allocator<int>, JemallocGrowth<>>>(40) == vector<size_t>{2, 4, 8, 12, 20, 32, 48});
+    print_test_result("Page rounded growth sequence test", true,
+        capacity_sequence<Vector<int, allocator<int>, PageRoundedGrowth<>>>(4000) == vector<size_t>{1024, 2048, 3072, 5120});
+    print_test_result("First growth hint test", true,
+        capacity_sequence<Vector<int, allocator<int>, FirstGrowthHint<100>>>(101) == vector<size_t>{100, 150});
+
+    // Test an empty Vector allocates nothing until its first element
+    static_assert(is_nothrow_default_constructible_v<Vector<string>>);
+    size_t before_lazy = counted_allocations;
+    Vector<int, CountingAllocator<int>> lazy;
+    Vector<int, CountingAllocator<int>> lazy_moved(std::move(lazy));
+    lazy_moved.clear();
+    lazy_moved.shrink_to_fit();
+    print_test_result("Lazy default construct test", size_t(0), counted_allocations - before_lazy);
+    print_test_result("Lazy capacity test", size_t(0), lazy_moved.capacity());
+    lazy_moved.push_back(1);
+    print_test_result("First push allocates test", size_t(1), counted_allocations - before_lazy);
+
+    // Test reverse iteration of an empty and a filled Vector
+    Vector<int> unfilled;
+    print_test_result("Empty reverse test", true, unfilled.rbegin() == unfilled.rend() && as_const(unfilled).crbegin() == unfilled.crend());
+    unfilled.assign({1, 2, 3});
+    const int backwards[] = {3, 2, 1};
+    print_test_result("Reverse iteration test", true, equal(unfilled.rbegin(), unfilled.rend(), begin(backwards), end(backwards)));
+
+    // Test resize_for_overwrite and append_uninitialized let the caller fill the new elements
+    Vector<char> bytes;
+    bytes.resize_for_overwrite(64);
+    fill(bytes.begin(), bytes.end(), 'a');
+    size_t written = bytes.append_uninitialized(32, [](char* dest, size_t) {
+        fill(dest, dest + 10, 'b');
+        return size_t(10);
+    });
+    print_test_result("Append uninitialized test", true, written == 10 && bytes.size() == 74 && bytes[73] == 'b' && bytes[63] == 'a');
+    bool over_reported = false;
+    try {
+        bytes.append_uninitialized(4, [](char*, size_t n) { return n + 1; });
+    } catch (const length_error&) {
+        over_reported = true;
+    }
+    print_test_result("Append uninitialized overrun test", true, over_reported && bytes.size() == 74);
+
+    // Test pmr::Vector leaves resize_for_overwrite elements as the resource handed them out
+    unsigned char marked[256];
+    memset(marked, 0xAB, sizeof(marked));
+    std::pmr::monotonic_buffer_resource marked_resource(marked, sizeof(marked), std::pmr::null_memory_resource());
+    ::pmr::Vector<unsigned char> overwritten(&marked_resource);
+    overwritten.resize_for_overwrite(64);
+    print_test_result("PMR resize for overwrite test", true, ranges::all_of(overwritten, [](unsigned char b) { return b == 0xAB; }));
+    overwritten.resize_for_overwrite(8);
+    print_test_result("PMR resize for overwrite shrink test", size_t(8), overwritten.size());
+
+    // Test the SIMD searches against std algorithms, with matches in the vector body and the scalar tail
+    Vector<int> haystack;
+    std::vector<int> reference;
+    for (int i = 0; i < 1003; ++i) {
+        haystack.push_back(i % 97);
+        reference.push_back(i % 97);
+    }
+    bool searches = true;
+    for (int needle : {0, 5, 96, 97, -1}) {
+        auto first = std::find(reference.begin(), reference.end(), needle);
+        auto last = std::find(reference.rbegin(), reference.rend(), needle);
+        size_t expected_index = first == reference.end() ? Vector<int>::npos : static_cast<size_t>(first - reference.begin());
+        size_t expected_rfind = last == reference.rend() ? Vector<int>::npos : static_cast<size_t>(reference.rend() - last - 1);
+        searches = searches && haystack.index(needle) == expected_index && haystack.rfind(needle) == expected_rfind
+            && haystack.count(needle) == static_cast<size_t>(std::count(reference.begin(), reference.end(), needle))
+            && haystack.contains(needle) == (first != reference.end());
+    }
+    print_test_result("SIMD search test", true, searches);
+
+    Vector<double> samples{0.5, 1.5, 2.5, -0.0, 3.5};
+    print_test_result("SIMD double search test", true, samples.index(0.0) == 3 && samples.rfind(3.5) == 4 && !samples.contains(4.0));
+
+    // Test the numeric kernels: strict reductions match std::accumulate bit for bit, fast ones closely
+    Vector<float> xs;
+    Vector<float> ys;
+    for (int i = 0; i < 1001; ++i) {
+        xs.push_back(0.1f * static_cast<float>(i % 37) - 1.0f);
+        ys.push_back(0.5f + 0.01f * static_cast<float>(i));
+    }
+    float strict_sum = vector_ops::sum(xs);
+    float fast_sum = vector_ops::sum<vector_ops::math_mode::fast>(xs);
+    print_test_result("Strict sum test", accumulate(xs.begin(), xs.end(), 0.0f), strict_sum);
+    print_test_result("Fast sum test", true, fabs(fast_sum - strict_sum) < 1e-3f);
+    print_test_result("Strict dot test", inner_product(xs.begin(), xs.end(), ys.begin(), 0.0f), vector_ops::dot(xs, ys));
+    print_test_result("Min max test", true, vector_ops::min(xs) == *min_element(xs.begin(), xs.end())
+        && vector_ops::max(ys) == *max_element(ys.begin(), ys.end()));
+
+    Vector<float> expected_axpy;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        expected_axpy.push_back(2.0f * xs[i] + ys[i]);
+    }
+    vector_ops::axpy(2.0f, xs, ys);
+    print_test_result("Axpy test", true, ranges::equal(ys, expected_axpy));
+
+    // Test strict axpy rounds the product before the add, where an FMA would keep 2^-24 instead of 0
+    const float near_one = 1.0f + 1.0f / 4096.0f;
+    Vector<float> unfused_x(67, near_one);
+    Vector<float> unfused_y(67, -(1.0f + 1.0f / 2048.0f));
+    Vector<float> unfused_expected;
+    for (size_t i = 0; i < unfused_y.size(); ++i) {
+        volatile float product = near_one * unfused_x[i];
+        unfused_expected.push_back(unfused_y[i] + product);
+    }
+    vector_ops::axpy(near_one, unfused_x, unfused_y);
+    print_test_result("Strict axpy unfused test", true, ranges::equal(unfused_y, unfused_expected) && unfused_y[0] == 0.0f);
+
+    // Test strict dot rounds each product too: -(1 + 2^-11) plus near_one squared must give 0, not 2^-24
+    Vector<float> unfused_dot_x{1.0f, near_one};
+    Vector<float> unfused_dot_y{-(1.0f + 1.0f / 2048.0f), near_one};
+    volatile float rounded_square = near_one * near_one;
+    print_test_result("Strict dot unfused test", true, vector_ops::dot(unfused_dot_x, unfused_dot_y) == unfused_dot_y[0] + rounded_square
+        && vector_ops::dot(unfused_dot_x, unfused_dot_y) == 0.0f);
+    vector_ops::scale(ys, 0.5f);
+    vector_ops::transform_inplace(ys, [](float y) { return y * 2.0f; });
+    print_test_result("Scale and transform test", true, ranges::equal(ys, expected_axpy));
+
+    bool empty_min = false;
+    try {
+        vector_ops::min(Vector<float>());
+    } catch (const out_of_range&) {
+        empty_min = true;
+    }
+    print_test_result("Empty min test", true, empty_min);
+
+    // Test AlignedAllocator keeps every buffer on a cache line as the Vector grows and shrinks
+    Vector<double, AlignedAllocator<double, 64>> aligned;
+    static_assert(decltype(aligned)::alignment == 64);
+    bool aligned_always = true;
+    for (int i = 0; i < 1000; ++i) {
+        aligned.push_back(i);
+        aligned_always = aligned_always && reinterpret_cast<uintptr_t>(aligned.aligned_data()) % 64 == 0;
+    }
+    aligned.erase(size_t(10), aligned.size());
+    aligned.shrink_to_fit();
+    aligned_always = aligned_always && reinterpret_cast<uintptr_t>(aligned.data()) % 64 == 0;
+    print_test_result("Aligned storage test", true, aligned_always && aligned[9] == 9.0);
+
+    // Test arena and pool allocators: chunk overflow, recycled blocks and non-propagating copy assignment
+    Arena scratch(1024);
+    Vector<int, ArenaAllocator<int>> first_arena{ArenaAllocator<int>(scratch)};
+    Vector<int, ArenaAllocator<int>> second_arena{ArenaAllocator<int>(scratch)};
+    for (int i = 0; i < 10000; ++i) {
+        first_arena.push_back(i);
+        second_arena.push_back(-i);
+    }
+    print_test_result("Arena growth test", true, first_arena[9999] == 9999 && second_arena[9999] == -9999);
+
+    Arena arena;
+    Vector<int, ArenaAllocator<int>> expanded{ArenaAllocator<int>(arena)};
+    expanded.reserve(16);
+    int* arena_block = expanded.data();
+    for (int i = 0; i < 1000; ++i) {
+        expanded.push_back(i);
+    }
+    print_test_result("Try expand in place test", arena_block, expanded.data());
+
+    Pool pool;
+    Pool other_pool;
+    int* recycled = nullptr;
     {
-        Vector<int> custom_vec;
-        std::vector<int> std_vec;
+        Vector<int, PoolAllocator<int>> pooled{PoolAllocator<int>(pool)};
+        pooled.reserve(100);
+        recycled = pooled.data();
+    }
+    Vector<int, PoolAllocator<int>> reused{PoolAllocator<int>(pool)};
+    reused.reserve(120);
+    print_test_result("Pool recycle test", recycled, reused.data());
 
-        Timer custom_timer;
-        for (int i = 0; i < N/2; ++i) {
-            custom_vec.push_back(i);
-        }
-        for (int i = 0; i < N/4; ++i) {
-            custom_vec.pop_back();
-        }
-        for (int i = 0; i < N/4; ++i) {
-            custom_vec.push_back(i);
-        }
-        double custom_time = custom_timer.elapsed();
+    Vector<int, PoolAllocator<int>> foreign{PoolAllocator<int>(other_pool)};
+    foreign.push_back({1, 2, 3});
+    reused = foreign;
+    print_test_result("Pool copy assign test", true, reused.get_allocator().pool() == &pool && reused.size() == 3);
 
-        Timer std_timer;
-        for (int i = 0; i < N/2; ++i) {
-            std_vec.push_back(i);
-        }
-        for (int i = 0; i < N/4; ++i) {
-            std_vec.pop_back();
-        }
-        for (int i = 0; i < N/4; ++i) {
-            std_vec.push_back(i);
+    // Test pmr::Vector draws from its memory_resource and passes it on to pmr elements
+    std::byte buffer_storage[8192];
+    std::pmr::monotonic_buffer_resource resource(buffer_storage, sizeof(buffer_storage), std::pmr::null_memory_resource());
+    ::pmr::Vector<std::pmr::string> pmr_strings(&resource);
+    for (int i = 0; i < 20; ++i) {
+        pmr_strings.emplace_back("a string too long for the small buffer " + to_string(i));
+    }
+    print_test_result("PMR resource test", true, pmr_strings.get_allocator().resource() == &resource
+        && pmr_strings[19].get_allocator().resource() == &resource);
+
+    std::pmr::unsynchronized_pool_resource other_resource;
+    ::pmr::Vector<std::pmr::string> pmr_moved(std::move(pmr_strings), &other_resource);
+    print_test_result("PMR move to other resource test", true, pmr_moved.size() == 20
+        && pmr_moved[0].get_allocator().resource() == &other_resource && pmr_moved[0].ends_with(" 0"));
+
+    // Test copy assignment and copy_from reuse a buffer that is already large enough
+    Vector<string, CountingAllocator<string>> target;
+    target.reserve(100);
+    string* target_buffer = target.data();
+    Vector<string, CountingAllocator<string>> source{"one", "two", "three"};
+    size_t before_copy = counted_allocations;
+    target = source;
+    target.copy_from(span<const string>(source.data(), 2));
+    print_test_result("Copy assign reuse test", true, target.data() == target_buffer && counted_allocations == before_copy);
+    target.copy_from(span<const string>(target.data() + 1, 1));
+    print_test_result("Copy from self test", true, target.size() == 1 && target[0] == "two");
+
+    // Test erase_indices compacts in one sweep and rejects indices that are not strictly increasing
+    Vector<string> letters{"a", "b", "c", "d", "e", "f"};
+    const size_t doomed[] = {0, 2, 5};
+    letters.erase_indices(doomed);
+    const string kept[] = {"b", "d", "e"};
+    print_test_result("Erase indices test", true, ranges::equal(letters, kept));
+    auto rejected_indices = [&](initializer_list<size_t> indices) {
+        try {
+            letters.erase_indices(span<const size_t>(indices.begin(), indices.size()));
+        } catch (const out_of_range&) {
+            return ranges::equal(letters, kept);
         }
-        double std_time = std_timer.elapsed();
+        return false;
+    };
+    print_test_result("Erase unsorted indices test", true, rejected_indices({2, 0}));
+    print_test_result("Erase duplicate indices test", true, rejected_indices({1, 1}));
+    print_test_result("Erase index past end test", true, rejected_indices({0, 3}));
 
-        cout << "\nMixed operations test:\n";
-        cout << "Custom vector: " << custom_time << "ms\n";
-        cout << "STD vector: " << std_time << "ms\n";
-        cout << "Ratio (custom/std): " << custom_time/std_time << "\n";
+    size_t removed_strings = letters.erase_if([](const string& x) { return x != "d"; });
+    print_test_result("Erase if strings test", true, removed_strings == 2 && letters.size() == 1 && letters[0] == "d");
+    bool unordered_rejected = false;
+    try {
+        letters.unordered_erase(1);
+    } catch (const out_of_range&) {
+        unordered_rejected = true;
     }
+    print_test_result("Unordered erase range test", true, unordered_rejected);
 }
 
 int main() {
     test_functionality();
-    test_performance();
+    test_vector_features();
+    test_small_vector();
+    test_static_vector();
+    test_parallel();
+    test_mapped_vector();
+    test_concurrent_vector();
+    test_serialization();
+    test_incremental_vector();
+    test_segmented_vector();
+    test_soa_vector();
+    test_numa();
+    test_huge_pages();
+    test_checked_mode();
 
     return 0;
 }
@@ -0,0 +1,423 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "vector.h"
+
+// File-backed storage for trivially copyable elements, so a large table can be reopened in O(1)
+// instead of being deserialized on every start.
+//
+// The file starts with a 64-byte header (magic, format version, element size, size, capacity),
+// followed by the elements. MappedVector maps it read-write and MAP_SHARED: every change is a store
+// into the page cache, size is kept in the header, and growing extends the file with ftruncate and
+// the mapping with mremap (munmap + mmap where mremap does not exist). sync() flushes to disk with msync.
+// MappedView maps the same file read-only for other processes; it sees the size recorded when it was
+// opened and must not be used while a writer shrinks the file.
+namespace mapped_detail {
+
+inline constexpr char magic[8] = {'V', 'E', 'C', 'T', 'M', 'A', 'P', '\0'};
+inline constexpr uint32_t version = 1;
+inline constexpr size_t data_offset = 64;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t element_size;
+    uint64_t size;
+    uint64_t capacity;
+};
+
+static_assert(sizeof(Header) <= data_offset);
+
+[[noreturn]] inline void throw_errno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+inline size_t page_size() noexcept {
+    static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return page;
+}
+
+inline size_t page_round(size_t bytes) noexcept {
+    size_t page = page_size();
+    return (bytes + page - 1) & ~(page - 1);
+}
+
+// Checks that a mapping of length bytes holds a header written for elements of elementSize bytes.
+inline const Header* validate(const void* base, size_t length, size_t elementSize) {
+    if (length < data_offset) {
+        throw std::runtime_error("mapped file is too small to hold a header");
+    }
+    const Header* header = static_cast<const Header*>(base);
+    if (std::memcmp(header->magic, magic, sizeof(magic)) != 0) {
+        throw std::runtime_error("mapped file has no Vector header");
+    }
+    if (header->version != version) {
+        throw std::runtime_error("mapped file has an unsupported format version");
+    }
+    if (header->element_size != elementSize) {
+        throw std::runtime_error("mapped file was written for a different element size");
+    }
+    if (header->size > header->capacity || header->capacity > (length - data_offset) / elementSize) {
+        throw std::runtime_error("mapped file header does not match the file length");
+    }
+    return header;
+}
+
+class FileDescriptor {
+public:
+    explicit FileDescriptor(int fd = -1) noexcept : fd_(fd) {}
+    FileDescriptor(FileDescriptor&& other) noexcept : fd_(std::exchange(other.fd_, -1)) {}
+    FileDescriptor& operator=(FileDescriptor&& other) noexcept {
+        std::swap(fd_, other.fd_);
+        return *this;
+    }
+    ~FileDescriptor() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    [[nodiscard]] int get() const noexcept {
+        return fd_;
+    }
+
+private:
+    int fd_;
+};
+
+}
+
+template <typename T>
+class MappedView {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedView requires a trivially copyable element type");
+    static_assert(alignof(T) <= mapped_detail::data_offset, "MappedView does not support over-aligned types");
+
+public:
+    explicit MappedView(const char* path) {
+        mapped_detail::FileDescriptor fd(::open(path, O_RDONLY | O_CLOEXEC));
+        if (fd.get() < 0) {
+            mapped_detail::throw_errno("open");
+        }
+        struct stat st;
+        if (::fstat(fd.get(), &st) != 0) {
+            mapped_detail::throw_errno("fstat");
+        }
+        length_ = static_cast<size_t>(st.st_size);
+        base_ = length_ ? ::mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd.get(), 0) : MAP_FAILED;
+        if (base_ == MAP_FAILED) {
+            if (length_) {
+                mapped_detail::throw_errno("mmap");
+            }
+            throw std::runtime_error("mapped file is too small to hold a header");
+        }
+        try {
+            size_ = static_cast<size_t>(mapped_detail::validate(base_, length_, sizeof(T))->size);
+        }
+        catch (...) {
+            ::munmap(base_, length_);
+            throw;
+        }
+    }
+
+    MappedView(MappedView&& other) noexcept
+        : base_(std::exchange(other.base_, nullptr)), length_(std::exchange(other.length_, 0)),
+          size_(std::exchange(other.size_, 0)) {}
+
+    MappedView& operator=(MappedView other) noexcept {
+        std::swap(base_, other.base_);
+        std::swap(length_, other.length_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    ~MappedView() {
+        if (base_) {
+            ::munmap(base_, length_);
+        }
+    }
+
+    [[nodiscard]] const T* data() const noexcept {
+        return reinterpret_cast<const T*>(static_cast<const char*>(base_) + mapped_detail::data_offset);
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    const T& operator[](size_t index) const noexcept { return data()[index]; }
+
+    const T& at(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data()[index];
+    }
+
+    const T* begin() const noexcept { return data(); }
+    const T* end() const noexcept { return data() + size_; }
+
+    operator std::span<const T>() const noexcept { return {data(), size_}; }
+
+private:
+    void* base_;
+    size_t length_;
+    size_t size_;
+};
+
+template <typename T, class GrowthPolicy = DefaultGrowth>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector requires a trivially copyable element type");
+    static_assert(alignof(T) <= mapped_detail::data_offset, "MappedVector does not support over-aligned types");
+    static_assert(growth_policy<GrowthPolicy>, "GrowthPolicy must provide static next_capacity(capacity, required, elementSize)");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    enum class open_mode {
+        open_or_create, // reuse the contents of an existing file, start empty otherwise
+        truncate        // discard any existing contents
+    };
+
+    explicit MappedVector(const char* path, open_mode mode = open_mode::open_or_create)
+        : fd_(::open(path, O_RDWR | O_CREAT | O_CLOEXEC | (mode == open_mode::truncate ? O_TRUNC : 0), 0644)) {
+        if (fd_.get() < 0) {
+            mapped_detail::throw_errno("open");
+        }
+        struct stat st;
+        if (::fstat(fd_.get(), &st) != 0) {
+            mapped_detail::throw_errno("fstat");
+        }
+
+        if (st.st_size == 0) {
+            length_ = mapped_detail::page_round(mapped_detail::data_offset);
+            if (::ftruncate(fd_.get(), static_cast<off_t>(length_)) != 0) {
+                mapped_detail::throw_errno("ftruncate");
+            }
+            map();
+            mapped_detail::Header* h = header();
+            std::memcpy(h->magic, mapped_detail::magic, sizeof(h->magic));
+            h->version = mapped_detail::version;
+            h->element_size = sizeof(T);
+            h->size = 0;
+            h->capacity = (length_ - mapped_detail::data_offset) / sizeof(T);
+        }
+        else {
+            length_ = static_cast<size_t>(st.st_size);
+            map();
+            try {
+                mapped_detail::validate(base_, length_, sizeof(T));
+            }
+            catch (...) {
+                ::munmap(base_, length_);
+                throw;
+            }
+        }
+    }
+
+    MappedVector(MappedVector&& other) noexcept
+        : fd_(std::move(other.fd_)), base_(std::exchange(other.base_, nullptr)),
+          length_(std::exchange(other.length_, 0)) {}
+
+    MappedVector& operator=(MappedVector other) noexcept {
+        std::swap(fd_, other.fd_);
+        std::swap(base_, other.base_);
+        std::swap(length_, other.length_);
+        return *this;
+    }
+
+    ~MappedVector() {
+        if (base_) {
+            ::munmap(base_, length_);
+        }
+    }
+
+    [[nodiscard]] T* data() noexcept {
+        return reinterpret_cast<T*>(static_cast<char*>(base_) + mapped_detail::data_offset);
+    }
+
+    [[nodiscard]] const T* data() const noexcept {
+        return reinterpret_cast<const T*>(static_cast<const char*>(base_) + mapped_detail::data_offset);
+    }
+
+    // A moved-from MappedVector has no mapping and reports itself empty.
+    [[nodiscard]] size_t size() const noexcept { return base_ ? static_cast<size_t>(header()->size) : 0; }
+    [[nodiscard]] size_t capacity() const noexcept { return base_ ? static_cast<size_t>(header()->capacity) : 0; }
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    reference operator[](size_t index) noexcept { return data()[index]; }
+    const_reference operator[](size_t index) const noexcept { return data()[index]; }
+
+    reference at(size_t index) {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data()[index];
+    }
+
+    const_reference at(size_t index) const {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data()[index];
+    }
+
+    reference back() noexcept { return data()[size() - 1]; }
+    const_reference back() const noexcept { return data()[size() - 1]; }
+
+    iterator begin() noexcept { return data(); }
+    iterator end() noexcept { return data() + size(); }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + size(); }
+
+    operator std::span<T>() noexcept { return {data(), size()}; }
+    operator std::span<const T>() const noexcept { return {data(), size()}; }
+
+    void reserve(size_t newCapacity) {
+        if (newCapacity > capacity()) {
+            remap(newCapacity);
+        }
+    }
+
+    void push_back(const T& value) {
+        size_t n = size();
+        if (n == capacity()) {
+            // value may live in the mapping that grow() moves
+            T copy = value;
+            grow(n + 1);
+            std::memcpy(static_cast<void*>(data() + n), &copy, sizeof(T));
+        }
+        else {
+            std::memcpy(static_cast<void*>(data() + n), &value, sizeof(T));
+        }
+        header()->size = n + 1;
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        push_back(T(std::forward<Args>(args)...));
+    }
+
+    void append(std::span<const T> values) {
+        size_t n = size();
+        if (values.size() > capacity() - n) {
+            const T* source = values.data();
+            if (vector_detail::points_into(source, data(), data() + n)) {
+                size_t offset = static_cast<size_t>(source - data());
+                grow(n + values.size());
+                values = std::span<const T>(data() + offset, values.size());
+            }
+            else {
+                grow(n + values.size());
+            }
+        }
+        if (!values.empty()) {
+            std::memcpy(static_cast<void*>(data() + n), values.data(), values.size_bytes());
+        }
+        header()->size = n + values.size();
+    }
+
+    void pop_back() {
+        if (empty()) {
+            throw std::out_of_range("Vector is empty");
+        }
+        --header()->size;
+    }
+
+    // New elements are value-initialized.
+    void resize(size_t count) {
+        size_t n = size();
+        if (count > capacity()) {
+            grow(count);
+        }
+        if (count > n) {
+            std::memset(static_cast<void*>(data() + n), 0, (count - n) * sizeof(T));
+        }
+        header()->size = count;
+    }
+
+    void clear() noexcept {
+        if (base_) {
+            header()->size = 0;
+        }
+    }
+
+    // Writes the header and every dirty page back to the file before returning.
+    void sync() {
+        if (base_ && ::msync(base_, length_, MS_SYNC) != 0) {
+            mapped_detail::throw_errno("msync");
+        }
+    }
+
+private:
+    mapped_detail::Header* header() noexcept {
+        return static_cast<mapped_detail::Header*>(base_);
+    }
+
+    const mapped_detail::Header* header() const noexcept {
+        return static_cast<const mapped_detail::Header*>(base_);
+    }
+
+    void map() {
+        base_ = ::mmap(nullptr, length_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_.get(), 0);
+        if (base_ == MAP_FAILED) {
+            base_ = nullptr;
+            mapped_detail::throw_errno("mmap");
+        }
+    }
+
+    void grow(size_t required) {
+        remap(std::max(GrowthPolicy::next_capacity(capacity(), required, sizeof(T)), required));
+    }
+
+    // Extends the file so it holds at least newCapacity elements, then the mapping to match.
+    // The whole last page is usable, so the recorded capacity may exceed newCapacity. The file is
+    // never shortened: a shorter length would cut off elements that are already stored.
+    void remap(size_t newCapacity) {
+        // page_round may add up to a page less one byte on top of the header and elements
+        size_t headroom = mapped_detail::data_offset + mapped_detail::page_size() - 1;
+        if (newCapacity > (SIZE_MAX - headroom) / sizeof(T)) {
+            throw std::length_error("MappedVector size exceeds the addressable range");
+        }
+        size_t newLength = std::max(mapped_detail::page_round(mapped_detail::data_offset + newCapacity * sizeof(T)), length_);
+        if (::ftruncate(fd_.get(), static_cast<off_t>(newLength)) != 0) {
+            mapped_detail::throw_errno("ftruncate");
+        }
+#if defined(__linux__)
+        void* moved = ::mremap(base_, length_, newLength, MREMAP_MAYMOVE);
+        if (moved == MAP_FAILED) {
+            mapped_detail::throw_errno("mremap");
+        }
+        base_ = moved;
+        length_ = newLength;
+#else
+        // the pages live in the file, so dropping the old mapping loses nothing
+        ::munmap(base_, length_);
+        length_ = newLength;
+        map();
+#endif
+        header()->capacity = (length_ - mapped_detail::data_offset) / sizeof(T);
+    }
+
+    mapped_detail::FileDescriptor fd_;
+    void* base_ = nullptr;
+    size_t length_ = 0;
+};
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "parallel.h"
+#include "vector.h"
+
+// NUMA-aware construction and reservation for very large Vectors.
+//
+// Linux places a page on the node of the thread that first writes it, so a Vector filled by one
+// thread ends up entirely on that thread's node. numa::reserve and numa::make_vector apply a memory
+// policy to the fresh storage with mbind(2) and then fault the pages in from every thread of a
+// parallel::ThreadPool:
+//   placement::first_touch - no policy; each page lands on the node of whichever pool thread touched
+//                            it first. Which thread touches which page is not fixed.
+//   placement::interleave  - pages are spread round-robin over all nodes the process may use.
+//   placement::bind        - pages are allocated on numa_options::node only.
+// The policy is a hint: where mbind is unavailable or refused, the pages are still touched in
+// parallel and the kernel's default policy applies.
+namespace numa {
+
+enum class placement { first_touch, interleave, bind };
+
+struct numa_options {
+    placement policy = placement::first_touch;
+    int node = 0;
+    parallel::par_options parallel = {};
+};
+
+namespace detail {
+
+inline size_t page_size() noexcept {
+#if defined(__linux__)
+    static const size_t value = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return value;
+#else
+    return 4096;
+#endif
+}
+
+// Applies the policy to the whole pages inside [first, last); partial pages at either end are shared
+// with neighbouring allocations and keep their policy.
+inline bool apply_policy(void* first, void* last, const numa_options& options) noexcept {
+#if defined(__linux__) && defined(SYS_mbind)
+    if (options.policy == placement::first_touch) {
+        return true;
+    }
+    constexpr int mpolBind = 2;
+    constexpr int mpolInterleave = 3;
+    constexpr unsigned mpolMfMove = 1u << 1;
+
+    uintptr_t page = page_size();
+    uintptr_t begin = (reinterpret_cast<uintptr_t>(first) + page - 1) & ~(page - 1);
+    uintptr_t end = reinterpret_cast<uintptr_t>(last) & ~(page - 1);
+    if (begin >= end) {
+        return true;
+    }
+
+    unsigned long mask;
+    int mode;
+    if (options.policy == placement::interleave) {
+        mask = ~0ul;
+        mode = mpolInterleave;
+    }
+    else {
+        if (options.node < 0 || options.node >= static_cast<int>(sizeof(mask) * 8)) {
+            return false;
+        }
+        mask = 1ul << options.node;
+        mode = mpolBind;
+    }
+    // The kernel ignores nodes in the mask that the process may not use; maxnode counts one past the mask.
+    return syscall(SYS_mbind, begin, end - begin, mode, &mask, sizeof(mask) * 8 + 1, mpolMfMove) == 0;
+#else
+    (void)first;
+    (void)last;
+    (void)options;
+    return false;
+#endif
+}
+
+// Writes one byte per page of raw storage from the pool so that each page is faulted in by a pool thread.
+inline void touch_pages(void* first, void* last, const numa_options& options) {
+    char* begin = static_cast<char*>(first);
+    size_t bytes = static_cast<size_t>(static_cast<char*>(last) - begin);
+    size_t page = page_size();
+    size_t pages = (bytes + page - 1) / page;
+    parallel::detail::for_chunks(pages, options.parallel, [&](size_t firstPage, size_t lastPage) {
+        for (size_t p = firstPage; p < lastPage; ++p) {
+            *static_cast<volatile char*>(begin + p * page) = 0;
+        }
+    });
+}
+
+}
+
+// Reserves room for at least capacity elements, places the unused part of the storage according to
+// options.policy and faults it in from the pool. Elements already in v are not moved between nodes
+// except by the reallocation reserve itself performs.
+template <typename T, class Alloc, class Growth, size_t N>
+void reserve(Vector<T, Alloc, Growth, N>& v, size_t capacity, const numa_options& options = {}) {
+    v.reserve(capacity);
+    void* first = v.data() + v.size();
+    void* last = v.data() + v.capacity();
+    detail::apply_policy(first, last, options);
+    detail::touch_pages(first, last, options);
+}
+
+// Builds a Vector of count copies of value. Trivially copyable elements are written by the pool directly,
+// so the fill is the first touch; other types are constructed in order into storage already faulted in
+// by numa::reserve.
+template <class V>
+V make_vector(size_t count, const typename V::value_type& value, const numa_options& options = {}) {
+    using T = typename V::value_type;
+    V v;
+    if constexpr (std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>) {
+        v.reserve(count);
+        detail::apply_policy(v.data(), v.data() + v.capacity(), options);
+        v.append_uninitialized(count, [&](T* dest, size_t n) {
+            parallel::detail::for_chunks(n, options.parallel, [&](size_t first, size_t last) {
+                std::fill(dest + first, dest + last, value);
+            });
+            return n;
+        });
+    }
+    else {
+        numa::reserve(v, count, options);
+        v.resize(count, value);
+    }
+    return v;
+}
+
+}
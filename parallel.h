@@ -0,0 +1,368 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Parallel algorithms over Vector's contiguous storage: par_for_each, par_transform, par_reduce,
+// par_sort and par_fill.
+//
+// The storage is cut into chunks of par_options::chunk_size elements and the chunks are run on a
+// ThreadPool. Every participant (the workers plus the calling thread) starts with an equal share of
+// the chunks, takes them from the front of its share and, once that is empty, steals chunks from the
+// back of the others, so a slow chunk does not hold the rest of the job back.
+// A call made from inside a pool task runs serially instead of waiting on the pool it is running on.
+// The first exception thrown by a chunk cancels the chunks not yet started and is rethrown to the caller.
+namespace parallel {
+
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 1))
+        : participants_(std::max<size_t>(threads, 1)), slots_(std::make_unique<Slot[]>(participants_)) {
+        workers_.reserve(participants_ - 1);
+        for (size_t id = 0; id + 1 < participants_; ++id) {
+            workers_.emplace_back([this, id] { workerLoop(id); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    static ThreadPool& instance() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    // Number of threads that run chunks, the calling thread included.
+    [[nodiscard]] size_t size() const noexcept {
+        return participants_;
+    }
+
+    // Chunk indices share one 64-bit word per participant, 32 bits each.
+    static constexpr size_t max_chunks = 0xffffffffu;
+
+    // Calls fn(chunk) for every chunk in [0, chunks) and returns once all of them have finished.
+    // chunks must not exceed max_chunks.
+    template <typename Fn>
+    void run(size_t chunks, Fn&& fn) {
+        if (chunks == 0) {
+            return;
+        }
+        if (chunks > max_chunks) {
+            throw std::length_error("ThreadPool::run chunk count exceeds max_chunks");
+        }
+        if (chunks == 1 || participants_ == 1 || insideTask()) {
+            for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                fn(chunk);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> submit(submit_);
+        job_ = [](void* context, size_t chunk) { (*static_cast<std::remove_reference_t<Fn>*>(context))(chunk); };
+        context_ = std::addressof(fn);
+        error_ = nullptr;
+        cancelled_.store(false, std::memory_order_relaxed);
+        for (size_t id = 0; id < participants_; ++id) {
+            slots_[id].range.store(pack(chunks * id / participants_, chunks * (id + 1) / participants_),
+                std::memory_order_relaxed);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_ = workers_.size();
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        work(participants_ - 1);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0; });
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    // A participant's remaining chunks [begin, end), packed as begin << 32 | end so that the owner
+    // (taking from the front) and thieves (taking from the back) can claim a chunk with a single CAS.
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> range{0};
+    };
+
+    static constexpr uint64_t pack(size_t begin, size_t end) noexcept {
+        VECTOR_CHECK(begin <= end && end <= max_chunks, "ThreadPool chunk range", end, max_chunks);
+        return static_cast<uint64_t>(begin) << 32 | static_cast<uint64_t>(end);
+    }
+
+    static bool& insideTask() noexcept {
+        thread_local bool inside = false;
+        return inside;
+    }
+
+    static std::optional<size_t> claim(Slot& slot, bool front) noexcept {
+        uint64_t range = slot.range.load(std::memory_order_relaxed);
+        while (true) {
+            size_t begin = static_cast<size_t>(range >> 32);
+            size_t end = static_cast<size_t>(range & 0xffffffffu);
+            if (begin >= end) {
+                return std::nullopt;
+            }
+            uint64_t next = front ? pack(begin + 1, end) : pack(begin, end - 1);
+            if (slot.range.compare_exchange_weak(range, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return front ? begin : end - 1;
+            }
+        }
+    }
+
+    void work(size_t self) {
+        bool& inside = insideTask();
+        bool wasInside = std::exchange(inside, true);
+        while (!cancelled_.load(std::memory_order_relaxed)) {
+            std::optional<size_t> chunk = claim(slots_[self], true);
+            for (size_t step = 1; !chunk && step < participants_; ++step) {
+                chunk = claim(slots_[(self + step) % participants_], false);
+            }
+            if (!chunk) {
+                break;
+            }
+            try {
+                job_(context_, *chunk);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+                cancelled_.store(true, std::memory_order_relaxed);
+            }
+        }
+        inside = wasInside;
+    }
+
+    void workerLoop(size_t id) {
+        size_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) {
+                    return;
+                }
+                seen = generation_;
+            }
+
+            work(id);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--pending_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    size_t participants_;
+    std::unique_ptr<Slot[]> slots_;
+    Vector<std::thread> workers_;
+
+    std::mutex submit_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    size_t generation_ = 0;
+    size_t pending_ = 0;
+    bool stop_ = false;
+
+    void (*job_)(void*, size_t) = nullptr;
+    void* context_ = nullptr;
+    std::exception_ptr error_;
+    std::atomic<bool> cancelled_{false};
+};
+
+struct par_options {
+    size_t chunk_size = 16384;
+    ThreadPool* pool = nullptr;
+};
+
+namespace detail {
+
+inline ThreadPool& pool_of(const par_options& options) {
+    return options.pool ? *options.pool : ThreadPool::instance();
+}
+
+// Calls fn(first, last) for consecutive chunks covering [0, n).
+template <typename Fn>
+void for_chunks(size_t n, const par_options& options, Fn&& fn) {
+    size_t chunk = std::max<size_t>(options.chunk_size, 1);
+    size_t chunks = (n + chunk - 1) / chunk;
+    pool_of(options).run(chunks, [&](size_t index) {
+        size_t first = index * chunk;
+        fn(first, std::min(first + chunk, n));
+    });
+}
+
+// Output position `diagonal` of merging a[0, na) with b[0, nb) takes its first `result` elements from a.
+// Ties go to a, as in std::merge.
+template <typename T, typename Compare>
+size_t merge_split(const T* a, size_t na, const T* b, size_t nb, size_t diagonal, Compare& comp) {
+    size_t low = diagonal > nb ? diagonal - nb : 0;
+    size_t high = std::min(diagonal, na);
+    while (low < high) {
+        size_t i = low + (high - low) / 2;
+        if (!comp(b[diagonal - i - 1], a[i])) {
+            low = i + 1;
+        }
+        else {
+            high = i;
+        }
+    }
+    return low;
+}
+
+}
+
+template <typename T, class Alloc, class Growth, size_t N, typename Fn>
+void par_for_each(Vector<T, Alloc, Growth, N>& v, Fn fn, const par_options& options = {}) {
+    T* data = v.data();
+    detail::for_chunks(v.size(), options, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            fn(data[i]);
+        }
+    });
+}
+
+// out[i] = fn(in[i]); out may be the same Vector as in.
+template <typename T, class Alloc, class Growth, size_t N, typename U, class OutAlloc, class OutGrowth, size_t OutN,
+    typename Fn>
+void par_transform(const Vector<T, Alloc, Growth, N>& in, Vector<U, OutAlloc, OutGrowth, OutN>& out, Fn fn,
+    const par_options& options = {}) {
+    if (out.size() < in.size()) {
+        throw std::invalid_argument("par_transform requires an output at least as large as the input");
+    }
+    const T* src = in.data();
+    U* dst = out.data();
+    detail::for_chunks(in.size(), options, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            dst[i] = fn(src[i]);
+        }
+    });
+}
+
+// Folds every chunk separately and then combines the partial results in chunk order, so op must be
+// associative but need not be commutative.
+template <typename T, class Alloc, class Growth, size_t N, typename R, typename BinaryOp = std::plus<>>
+R par_reduce(const Vector<T, Alloc, Growth, N>& v, R init, BinaryOp op = {}, const par_options& options = {}) {
+    size_t chunk = std::max<size_t>(options.chunk_size, 1);
+    size_t chunks = (v.size() + chunk - 1) / chunk;
+    auto partials = std::make_unique<std::optional<R>[]>(chunks);
+    const T* data = v.data();
+    detail::pool_of(options).run(chunks, [&](size_t index) {
+        size_t first = index * chunk;
+        size_t last = std::min(first + chunk, v.size());
+        R acc = static_cast<R>(data[first]);
+        for (size_t i = first + 1; i < last; ++i) {
+            acc = op(std::move(acc), data[i]);
+        }
+        partials[index].emplace(std::move(acc));
+    });
+
+    for (size_t index = 0; index < chunks; ++index) {
+        init = op(std::move(init), std::move(*partials[index]));
+    }
+    return init;
+}
+
+template <typename T, class Alloc, class Growth, size_t N>
+void par_fill(Vector<T, Alloc, Growth, N>& v, const T& value, const par_options& options = {}) {
+    T* data = v.data();
+    detail::for_chunks(v.size(), options, [&](size_t first, size_t last) {
+        std::fill(data + first, data + last, value);
+    });
+}
+
+// Merge sort: every chunk is sorted with std::sort, then runs are merged pairwise, each level split
+// into chunk-sized pieces along the merge path so that all threads share every level, the last included.
+// The scratch buffer holds v.size() default-initialized elements; types that are not default
+// constructible are sorted serially. The sort is not stable.
+template <typename T, class Alloc, class Growth, size_t N, typename Compare = std::less<>>
+void par_sort(Vector<T, Alloc, Growth, N>& v, Compare comp = {}, const par_options& options = {}) {
+    size_t n = v.size();
+    size_t chunk = std::max<size_t>(options.chunk_size, 1);
+    if constexpr (!std::is_default_constructible_v<T>) {
+        std::sort(v.begin(), v.end(), comp);
+        return;
+    }
+    else {
+        if (n <= chunk || detail::pool_of(options).size() == 1) {
+            std::sort(v.begin(), v.end(), comp);
+            return;
+        }
+
+        detail::for_chunks(n, options, [&](size_t first, size_t last) {
+            std::sort(v.data() + first, v.data() + last, comp);
+        });
+
+        std::unique_ptr<T[]> buffer = std::make_unique_for_overwrite<T[]>(n);
+        T* src = v.data();
+        T* dst = buffer.get();
+        size_t chunks = (n + chunk - 1) / chunk;
+        auto splits = std::make_unique_for_overwrite<size_t[]>(chunks);
+        for (size_t width = chunk; width < n; width *= 2) {
+            // Runs and pieces both start at multiples of chunk, so a piece never straddles two merges.
+            // All split points are found before any element is moved out of src.
+            detail::for_chunks(n, options, [&](size_t first, size_t) {
+                size_t start = first / (2 * width) * (2 * width);
+                size_t mid = std::min(start + width, n);
+                size_t end = std::min(start + 2 * width, n);
+                splits[first / chunk] = detail::merge_split(src + start, mid - start, src + mid, end - mid,
+                    first - start, comp);
+            });
+            detail::for_chunks(n, options, [&](size_t first, size_t last) {
+                size_t start = first / (2 * width) * (2 * width);
+                size_t mid = std::min(start + width, n);
+                size_t end = std::min(start + 2 * width, n);
+                size_t i0 = splits[first / chunk];
+                size_t i1 = last == end ? mid - start : splits[last / chunk];
+                std::merge(std::make_move_iterator(src + start + i0), std::make_move_iterator(src + start + i1),
+                    std::make_move_iterator(src + mid + (first - start - i0)),
+                    std::make_move_iterator(src + mid + (last - start - i1)), dst + first, comp);
+            });
+            std::swap(src, dst);
+        }
+
+        if (src != v.data()) {
+            T* out = v.data();
+            detail::for_chunks(n, options, [&](size_t first, size_t last) {
+                std::move(src + first, src + last, out + first);
+            });
+        }
+    }
+}
+
+}
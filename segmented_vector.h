@@ -0,0 +1,414 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "parallel.h"
+#include "vector.h"
+
+// Vector-like container made of fixed-size chunks of ChunkSize elements (a power of two).
+//
+// Growing adds a chunk: existing elements never move and no second copy of the data is ever alive,
+// so the worst push_back costs one chunk allocation plus, rarely, growing the table of chunk pointers.
+// Element i lives at chunks_[i >> shift][i & mask]. References stay valid as the container grows;
+// iterators are random access but not contiguous and, like Vector's, are invalidated by growth.
+// for_each_chunk and parallel::par_for_each hand out whole chunks as spans. to_vector() produces a
+// contiguous Vector; on an rvalue it releases every chunk as soon as it has been moved, so the peak
+// footprint is the Vector plus one chunk.
+template <typename T>
+inline constexpr size_t default_chunk_size = std::bit_floor(std::max<size_t>(1, (size_t(64) << 10) / sizeof(T)));
+
+template <typename T, size_t ChunkSize = default_chunk_size<T>, class Alloc = std::allocator<T>>
+class SegmentedVector {
+    static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "ChunkSize must be a power of two");
+
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    static constexpr size_t shift = static_cast<size_t>(std::countr_zero(ChunkSize));
+    static constexpr size_t mask = ChunkSize - 1;
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+    static constexpr size_t chunk_size = ChunkSize;
+
+    SegmentedVector() noexcept(std::is_nothrow_default_constructible_v<Alloc>) = default;
+
+    explicit SegmentedVector(const Alloc& allocator) noexcept : alloc_(allocator) {}
+
+    SegmentedVector(std::initializer_list<T> values) {
+        for (const T& value : values) {
+            push_back(value);
+        }
+    }
+
+    SegmentedVector(const SegmentedVector& other)
+        : alloc_(AllocTraits::select_on_container_copy_construction(other.alloc_)) {
+        reserve(other.size_);
+        for (const T& value : other) {
+            push_back(value);
+        }
+    }
+
+    SegmentedVector(SegmentedVector&& other) noexcept
+        : chunks_(std::move(other.chunks_)), size_(std::exchange(other.size_, 0)), alloc_(std::move(other.alloc_)) {}
+
+    SegmentedVector& operator=(SegmentedVector other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~SegmentedVector() {
+        clear();
+        releaseChunks(0);
+    }
+
+    void swap(SegmentedVector& other) noexcept {
+        using std::swap;
+        swap(chunks_, other.chunks_);
+        swap(size_, other.size_);
+        swap(alloc_, other.alloc_);
+    }
+
+    template <bool isConst>
+    class baseIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<isConst, const T*, T*>;
+        using reference = std::conditional_t<isConst, const T&, T&>;
+
+    private:
+        template <bool>
+        friend class baseIterator;
+
+        T* const* chunks;
+        size_t index;
+
+    public:
+        template <bool OtherIsConst, typename = std::enable_if_t<isConst && !OtherIsConst>>
+        baseIterator(const baseIterator<OtherIsConst>& other) noexcept : chunks(other.chunks), index(other.index) {}
+        baseIterator(T* const* c = nullptr, size_t i = 0) noexcept : chunks(c), index(i) {}
+
+        reference operator*() const noexcept { return chunks[index >> shift][index & mask]; }
+        pointer operator->() const noexcept { return &**this; }
+        reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+        baseIterator& operator++() noexcept {
+            ++index;
+            return *this;
+        }
+
+        baseIterator operator++(int) noexcept {
+            baseIterator tmp(*this);
+            ++index;
+            return tmp;
+        }
+
+        baseIterator& operator--() noexcept {
+            --index;
+            return *this;
+        }
+
+        baseIterator operator--(int) noexcept {
+            baseIterator tmp(*this);
+            --index;
+            return tmp;
+        }
+
+        baseIterator& operator+=(difference_type n) noexcept {
+            index += static_cast<size_t>(n);
+            return *this;
+        }
+
+        baseIterator operator+(difference_type n) const noexcept {
+            baseIterator tmp(*this);
+            tmp += n;
+            return tmp;
+        }
+
+        friend baseIterator operator+(difference_type n, const baseIterator& it) noexcept {
+            return it + n;
+        }
+
+        baseIterator& operator-=(difference_type n) noexcept {
+            index -= static_cast<size_t>(n);
+            return *this;
+        }
+
+        baseIterator operator-(difference_type n) const noexcept {
+            baseIterator tmp(*this);
+            tmp -= n;
+            return tmp;
+        }
+
+        difference_type operator-(const baseIterator& other) const noexcept {
+            return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+        }
+
+        bool operator==(const baseIterator& other) const noexcept {
+            return index == other.index;
+        }
+
+        auto operator<=>(const baseIterator& other) const noexcept {
+            return index <=> other.index;
+        }
+    };
+
+    using Iterator = baseIterator<false>;
+    using ConstIterator = baseIterator<true>;
+
+    Iterator begin() noexcept { return Iterator(chunks_.data(), 0); }
+    Iterator end() noexcept { return Iterator(chunks_.data(), size_); }
+    ConstIterator begin() const noexcept { return ConstIterator(chunks_.data(), 0); }
+    ConstIterator end() const noexcept { return ConstIterator(chunks_.data(), size_); }
+    ConstIterator cbegin() const noexcept { return begin(); }
+    ConstIterator cend() const noexcept { return end(); }
+
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+    [[nodiscard]] size_t capacity() const noexcept { return chunks_.size() * ChunkSize; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] Alloc get_allocator() const noexcept { return alloc_; }
+
+    [[nodiscard]] size_t chunk_count() const noexcept {
+        return (size_ + mask) >> shift;
+    }
+
+    // The elements of chunk k; only the last chunk may be shorter than ChunkSize.
+    [[nodiscard]] std::span<T> chunk(size_t k) noexcept {
+        return {chunks_[k], std::min(ChunkSize, size_ - (k << shift))};
+    }
+
+    [[nodiscard]] std::span<const T> chunk(size_t k) const noexcept {
+        return {chunks_[k], std::min(ChunkSize, size_ - (k << shift))};
+    }
+
+    template <typename Fn>
+    void for_each_chunk(Fn&& fn) {
+        for (size_t k = 0; k < chunk_count(); ++k) {
+            fn(chunk(k));
+        }
+    }
+
+    reference operator[](size_t index) noexcept { return chunks_[index >> shift][index & mask]; }
+    const_reference operator[](size_t index) const noexcept { return chunks_[index >> shift][index & mask]; }
+
+    reference at(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return (*this)[index];
+    }
+
+    const_reference at(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return (*this)[index];
+    }
+
+    reference front() { return at(0); }
+    const_reference front() const { return at(0); }
+    reference back() { return at(size_ - 1); }
+    const_reference back() const { return at(size_ - 1); }
+
+    void reserve(size_t newCapacity) {
+        size_t needed = (newCapacity + mask) >> shift;
+        chunks_.reserve(needed);
+        while (chunks_.size() < needed) {
+            addChunk();
+        }
+    }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (size_ == capacity()) {
+            addChunk();
+        }
+        T* slot = chunks_[size_ >> shift] + (size_ & mask);
+        AllocTraits::construct(alloc_, slot, std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    void pop_back() {
+        if (empty()) {
+            throw std::out_of_range("Vector is empty");
+        }
+        --size_;
+        AllocTraits::destroy(alloc_, &(*this)[size_]);
+    }
+
+    void insert(const T& element, size_t index) {
+        if (index > size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        if (index == size_) {
+            push_back(element);
+            return;
+        }
+        T copy(element);
+        emplace_back(std::move(back()));
+        std::move_backward(begin() + index, end() - 2, end() - 1);
+        (*this)[index] = std::move(copy);
+    }
+
+    void insert(const T& element, Iterator pos) {
+        auto index = pos - begin();
+        if (index < 0) {
+            throw std::out_of_range("Index out of range");
+        }
+        insert(element, static_cast<size_t>(index));
+    }
+
+    void erase(size_t index) {
+        erase(index, index + 1);
+    }
+
+    void erase(size_t first, size_t last) {
+        if (first > last || last > size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        std::move(begin() + last, end(), begin() + first);
+        size_t count = last - first;
+        for (size_t i = 0; i < count; ++i) {
+            pop_back();
+        }
+    }
+
+    void resize(size_t count) {
+        while (size_ > count) {
+            pop_back();
+        }
+        reserve(count);
+        while (size_ < count) {
+            emplace_back();
+        }
+    }
+
+    void resize(size_t count, const T& value) {
+        while (size_ > count) {
+            pop_back();
+        }
+        reserve(count);
+        while (size_ < count) {
+            emplace_back(value);
+        }
+    }
+
+    void clear() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t k = 0; k < chunk_count(); ++k) {
+                for (T& value : chunk(k)) {
+                    AllocTraits::destroy(alloc_, &value);
+                }
+            }
+        }
+        size_ = 0;
+    }
+
+    // Releases the chunks past the last element.
+    void shrink_to_fit() {
+        releaseChunks(chunk_count());
+        chunks_.shrink_to_fit();
+    }
+
+    template <class V = Vector<T>>
+    V to_vector() const& {
+        V result;
+        result.reserve(size_);
+        for (size_t k = 0; k < chunk_count(); ++k) {
+            result.append_range(chunk(k));
+        }
+        return result;
+    }
+
+    template <class V = Vector<T>>
+    V to_vector() && {
+        if constexpr (!std::is_nothrow_move_constructible_v<T>) {
+            // a throwing move would leave the chunks half released, so copy instead
+            V result = to_vector();
+            clear();
+            releaseChunks(0);
+            return result;
+        }
+        else {
+            V result;
+            result.reserve(size_);
+            size_t used = chunk_count();
+            for (size_t k = 0; k < used; ++k) {
+                for (T& value : chunk(k)) {
+                    result.push_back(std::move(value));
+                    AllocTraits::destroy(alloc_, &value);
+                }
+                AllocTraits::deallocate(alloc_, chunks_[k], ChunkSize);
+            }
+            for (size_t k = used; k < chunks_.size(); ++k) {
+                AllocTraits::deallocate(alloc_, chunks_[k], ChunkSize);
+            }
+            size_ = 0;
+            chunks_.clear();
+            return result;
+        }
+    }
+
+private:
+    void addChunk() {
+        T* fresh = AllocTraits::allocate(alloc_, ChunkSize);
+        try {
+            chunks_.push_back(fresh);
+        }
+        catch (...) {
+            AllocTraits::deallocate(alloc_, fresh, ChunkSize);
+            throw;
+        }
+    }
+
+    // Frees every allocated chunk from index k on; they must hold no elements.
+    void releaseChunks(size_t k) noexcept {
+        while (chunks_.size() > k) {
+            AllocTraits::deallocate(alloc_, chunks_.back(), ChunkSize);
+            chunks_.erase(chunks_.size() - 1);
+        }
+    }
+
+    Vector<T*> chunks_;
+    size_t size_ = 0;
+    [[no_unique_address]] Alloc alloc_;
+};
+
+namespace parallel {
+
+// One pool task per chunk, so options.chunk_size is ignored and ChunkSize sets the granularity.
+template <typename T, size_t ChunkSize, class Alloc, typename Fn>
+void par_for_each(SegmentedVector<T, ChunkSize, Alloc>& v, Fn fn, const par_options& options = {}) {
+    detail::pool_of(options).run(v.chunk_count(), [&](size_t k) {
+        for (T& value : v.chunk(k)) {
+            fn(value);
+        }
+    });
+}
+
+}
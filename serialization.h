@@ -0,0 +1,571 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(VECTOR_IO_LZ4)
+#include <lz4.h>
+#endif
+
+#include "vector.h"
+
+// Binary serialization of Vector to file descriptors and iostreams.
+//
+// A stream is a 24-byte header (magic, format version, byte order, compression, element size, count),
+// the payload, and a 16-byte trailer with the payload length and a Fletcher-64 checksum of it. The
+// checksum sits after the payload so that non-trivial elements can be streamed without buffering
+// the whole encoding.
+//
+// Trivially copyable elements are written as one block of memory: a single writev of header, data and
+// trailer for a file descriptor, and read straight into the Vector's storage. Other types are encoded
+// element by element through codec<T> into block_size chunks; codec is provided for std::basic_string
+// and can be specialized for user types. Data is stored in the writer's byte order and rejected on a
+// machine with the other one.
+//
+// compression::lz4 compresses the payload in independent block_size blocks and requires building with
+// VECTOR_IO_LZ4 defined and linking liblz4. read_from leaves the Vector untouched if anything fails.
+namespace vector_io {
+
+enum class compression : uint8_t { none = 0, lz4 = 1 };
+
+struct write_options {
+    compression codec = compression::none;
+    size_t block_size = size_t(1) << 20;
+};
+
+inline constexpr uint16_t format_version = 1;
+
+// Default codec for trivially copyable types; specialize with
+//     template <class Encoder> static void encode(Encoder& out, const T& value)
+//     template <class Decoder> static T decode(Decoder& in)
+template <typename T>
+struct codec {
+    static_assert(std::is_trivially_copyable_v<T>, "vector_io::codec must be specialized for non-trivially copyable types");
+
+    template <class Encoder>
+    static void encode(Encoder& out, const T& value) {
+        out.write(&value, sizeof(T));
+    }
+
+    template <class Decoder>
+    static T decode(Decoder& in) {
+        T value;
+        in.read(&value, sizeof(T));
+        return value;
+    }
+};
+
+template <typename Char, class Traits, class Alloc>
+struct codec<std::basic_string<Char, Traits, Alloc>> {
+    template <class Encoder>
+    static void encode(Encoder& out, const std::basic_string<Char, Traits, Alloc>& value) {
+        out.template write_value<uint64_t>(value.size());
+        out.write(value.data(), value.size() * sizeof(Char));
+    }
+
+    template <class Decoder>
+    static std::basic_string<Char, Traits, Alloc> decode(Decoder& in) {
+        uint64_t length = in.template read_value<uint64_t>();
+        std::basic_string<Char, Traits, Alloc> value;
+        // grow with the bytes actually read so that a corrupt length cannot request a huge allocation
+        constexpr size_t step = 4096;
+        while (length > 0) {
+            size_t n = static_cast<size_t>(std::min<uint64_t>(length, step));
+            size_t offset = value.size();
+            value.resize(offset + n);
+            in.read(value.data() + offset, n * sizeof(Char));
+            length -= n;
+        }
+        return value;
+    }
+};
+
+namespace detail {
+
+inline constexpr char magic[4] = {'V', 'S', 'E', 'R'};
+inline constexpr uint8_t native_order = std::endian::native == std::endian::little ? 1 : 2;
+inline constexpr size_t max_block_size = size_t(1) << 30;
+
+struct Header {
+    char magic[4];
+    uint16_t version;
+    uint8_t byte_order;
+    uint8_t codec;
+    uint32_t element_size;
+    uint32_t reserved;
+    uint64_t count;
+};
+
+struct Trailer {
+    uint64_t payload_bytes;
+    uint64_t checksum;
+};
+
+static_assert(sizeof(Header) == 24 && sizeof(Trailer) == 16);
+
+// Fletcher-64 over little-endian 32-bit words; a trailing partial word is zero-padded.
+class Fletcher64 {
+public:
+    void update(const void* data, size_t n) noexcept {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        while (pendingBytes_ != 0 && n != 0) {
+            takeByte(*p++);
+            --n;
+        }
+        while (n >= 4) {
+            // 2^14 words keep b below 2^61 before the modulo
+            size_t words = std::min<size_t>(n / 4, size_t(1) << 14);
+            for (size_t i = 0; i < words; ++i) {
+                uint32_t word;
+                std::memcpy(&word, p + 4 * i, 4);
+                if constexpr (std::endian::native == std::endian::big) {
+                    word = __builtin_bswap32(word);
+                }
+                a_ += word;
+                b_ += a_;
+            }
+            a_ %= modulus;
+            b_ %= modulus;
+            p += 4 * words;
+            n -= 4 * words;
+        }
+        while (n != 0) {
+            takeByte(*p++);
+            --n;
+        }
+    }
+
+    [[nodiscard]] uint64_t value() const noexcept {
+        uint64_t a = a_;
+        uint64_t b = b_;
+        if (pendingBytes_ != 0) {
+            a = (a + pending_) % modulus;
+            b = (b + a) % modulus;
+        }
+        return b << 32 | a;
+    }
+
+private:
+    static constexpr uint64_t modulus = 0xffffffffu;
+
+    void takeByte(unsigned char byte) noexcept {
+        pending_ |= static_cast<uint32_t>(byte) << (8 * pendingBytes_);
+        if (++pendingBytes_ == 4) {
+            a_ = (a_ + pending_) % modulus;
+            b_ = (b_ + a_) % modulus;
+            pending_ = 0;
+            pendingBytes_ = 0;
+        }
+    }
+
+    uint64_t a_ = 0;
+    uint64_t b_ = 0;
+    uint32_t pending_ = 0;
+    unsigned pendingBytes_ = 0;
+};
+
+[[noreturn]] inline void throw_errno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+[[noreturn]] inline void throw_corrupt(const char* what) {
+    throw std::runtime_error(std::string("vector_io: ") + what);
+}
+
+class FdSink {
+public:
+    explicit FdSink(int fd) noexcept : fd_(fd) {}
+
+    void write(const void* data, size_t n) {
+        iovec part{const_cast<void*>(data), n};
+        writev(&part, 1);
+    }
+
+    // Writes every buffer in order, retrying after partial writes and EINTR.
+    void writev(iovec* parts, int count) {
+        while (count > 0) {
+            ssize_t written = ::writev(fd_, parts, std::min(count, 1024));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw_errno("writev");
+            }
+            size_t left = static_cast<size_t>(written);
+            while (count > 0 && left >= parts->iov_len) {
+                left -= parts->iov_len;
+                ++parts;
+                --count;
+            }
+            if (count > 0) {
+                parts->iov_base = static_cast<char*>(parts->iov_base) + left;
+                parts->iov_len -= left;
+            }
+        }
+    }
+
+private:
+    int fd_;
+};
+
+class FdSource {
+public:
+    explicit FdSource(int fd) noexcept : fd_(fd) {}
+
+    void read(void* data, size_t n) {
+        char* p = static_cast<char*>(data);
+        while (n > 0) {
+            ssize_t got = ::read(fd_, p, std::min<size_t>(n, std::numeric_limits<ssize_t>::max()));
+            if (got < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw_errno("read");
+            }
+            if (got == 0) {
+                throw_corrupt("unexpected end of input");
+            }
+            p += got;
+            n -= static_cast<size_t>(got);
+        }
+    }
+
+private:
+    int fd_;
+};
+
+class StreamSink {
+public:
+    explicit StreamSink(std::ostream& out) noexcept : out_(out) {}
+
+    void write(const void* data, size_t n) {
+        const char* p = static_cast<const char*>(data);
+        while (n > 0) {
+            size_t part = std::min<size_t>(n, static_cast<size_t>(std::numeric_limits<std::streamsize>::max()));
+            if (!out_.write(p, static_cast<std::streamsize>(part))) {
+                throw std::runtime_error("vector_io: stream write failed");
+            }
+            p += part;
+            n -= part;
+        }
+    }
+
+private:
+    std::ostream& out_;
+};
+
+class StreamSource {
+public:
+    explicit StreamSource(std::istream& in) noexcept : in_(in) {}
+
+    void read(void* data, size_t n) {
+        char* p = static_cast<char*>(data);
+        while (n > 0) {
+            size_t part = std::min<size_t>(n, static_cast<size_t>(std::numeric_limits<std::streamsize>::max()));
+            if (!in_.read(p, static_cast<std::streamsize>(part))) {
+                throw_corrupt("unexpected end of input");
+            }
+            p += part;
+            n -= part;
+        }
+    }
+
+private:
+    std::istream& in_;
+};
+
+inline void check_codec(compression codec) {
+    if (codec == compression::none) {
+        return;
+    }
+#if defined(VECTOR_IO_LZ4)
+    if (codec == compression::lz4) {
+        return;
+    }
+#endif
+    throw std::invalid_argument("vector_io: compression codec not available in this build");
+}
+
+// Checksums the payload, cuts it into blocks and compresses them when asked to.
+// Compressed blocks are framed as raw size, stored size (equal to the raw size for a block that did
+// not shrink and is stored as is) and the stored bytes.
+template <class Sink>
+class BlockWriter {
+public:
+    BlockWriter(Sink& sink, const write_options& options)
+        : sink_(sink), codec_(options.codec), blockSize_(std::clamp<size_t>(options.block_size, 64, max_block_size)) {}
+
+    void write(const void* data, size_t n) {
+        checksum_.update(data, n);
+        payloadBytes_ += n;
+        if (codec_ == compression::none && buffer_.empty() && n >= blockSize_) {
+            sink_.write(data, n);
+            return;
+        }
+        const char* p = static_cast<const char*>(data);
+        while (n > 0) {
+            size_t part = std::min(n, blockSize_ - buffer_.size());
+            buffer_.append_range(std::span<const char>(p, part));
+            p += part;
+            n -= part;
+            if (buffer_.size() == blockSize_) {
+                flush();
+            }
+        }
+    }
+
+    template <typename U>
+    void write_value(const U& value) {
+        static_assert(std::is_trivially_copyable_v<U>);
+        write(&value, sizeof(U));
+    }
+
+    void finish() {
+        flush();
+        Trailer trailer{payloadBytes_, checksum_.value()};
+        sink_.write(&trailer, sizeof(trailer));
+    }
+
+private:
+    void flush() {
+        if (buffer_.empty()) {
+            return;
+        }
+        if (codec_ == compression::none) {
+            sink_.write(buffer_.data(), buffer_.size());
+        }
+        else {
+            writeCompressed();
+        }
+        buffer_.clear();
+    }
+
+    void writeCompressed() {
+        uint32_t frame[2] = {static_cast<uint32_t>(buffer_.size()), static_cast<uint32_t>(buffer_.size())};
+        const char* stored = buffer_.data();
+#if defined(VECTOR_IO_LZ4)
+        int bound = LZ4_compressBound(static_cast<int>(buffer_.size()));
+        compressed_.resize_for_overwrite(static_cast<size_t>(bound));
+        int size = LZ4_compress_default(buffer_.data(), compressed_.data(), static_cast<int>(buffer_.size()), bound);
+        if (size > 0 && static_cast<size_t>(size) < buffer_.size()) {
+            frame[1] = static_cast<uint32_t>(size);
+            stored = compressed_.data();
+        }
+#endif
+        sink_.write(frame, sizeof(frame));
+        sink_.write(stored, frame[1]);
+    }
+
+    Sink& sink_;
+    compression codec_;
+    size_t blockSize_;
+    Vector<char> buffer_;
+    Vector<char> compressed_;
+    Fletcher64 checksum_;
+    uint64_t payloadBytes_ = 0;
+};
+
+template <class Source>
+class BlockReader {
+public:
+    BlockReader(Source& source, compression codec) : source_(source), codec_(codec) {}
+
+    void read(void* data, size_t n) {
+        if (codec_ == compression::none) {
+            source_.read(data, n);
+        }
+        else {
+            char* p = static_cast<char*>(data);
+            size_t left = n;
+            while (left > 0) {
+                if (position_ == buffer_.size()) {
+                    readBlock();
+                }
+                size_t part = std::min(left, buffer_.size() - position_);
+                std::memcpy(p, buffer_.data() + position_, part);
+                position_ += part;
+                p += part;
+                left -= part;
+            }
+        }
+        checksum_.update(data, n);
+        payloadBytes_ += n;
+    }
+
+    template <typename U>
+    U read_value() {
+        static_assert(std::is_trivially_copyable_v<U>);
+        U value;
+        read(&value, sizeof(U));
+        return value;
+    }
+
+    void finish() {
+        if (position_ != buffer_.size()) {
+            throw_corrupt("payload is longer than its elements");
+        }
+        Trailer trailer;
+        source_.read(&trailer, sizeof(trailer));
+        if (trailer.payload_bytes != payloadBytes_) {
+            throw_corrupt("payload length does not match the trailer");
+        }
+        if (trailer.checksum != checksum_.value()) {
+            throw_corrupt("checksum mismatch");
+        }
+    }
+
+private:
+    void readBlock() {
+        uint32_t frame[2];
+        source_.read(frame, sizeof(frame));
+        if (frame[0] == 0 || frame[0] > max_block_size || frame[1] > frame[0]) {
+            throw_corrupt("invalid block frame");
+        }
+        buffer_.resize_for_overwrite(frame[0]);
+        position_ = 0;
+        if (frame[1] == frame[0]) {
+            source_.read(buffer_.data(), frame[0]);
+            return;
+        }
+#if defined(VECTOR_IO_LZ4)
+        compressed_.resize_for_overwrite(frame[1]);
+        source_.read(compressed_.data(), frame[1]);
+        int size = LZ4_decompress_safe(compressed_.data(), buffer_.data(), static_cast<int>(frame[1]),
+            static_cast<int>(frame[0]));
+        if (size != static_cast<int>(frame[0])) {
+            throw_corrupt("corrupt compressed block");
+        }
+#else
+        throw_corrupt("compressed block in a build without VECTOR_IO_LZ4");
+#endif
+    }
+
+    Source& source_;
+    compression codec_;
+    Vector<char> buffer_;
+    Vector<char> compressed_;
+    size_t position_ = 0;
+    Fletcher64 checksum_;
+    uint64_t payloadBytes_ = 0;
+};
+
+template <class Sink, typename T, class Alloc, class Growth, size_t N>
+void write_vector(Sink& sink, const Vector<T, Alloc, Growth, N>& v, const write_options& options) {
+    check_codec(options.codec);
+    Header header{{magic[0], magic[1], magic[2], magic[3]}, format_version, native_order,
+        static_cast<uint8_t>(options.codec), static_cast<uint32_t>(sizeof(T)), 0, static_cast<uint64_t>(v.size())};
+
+    if constexpr (std::is_trivially_copyable_v<T> && std::is_same_v<Sink, FdSink>) {
+        if (options.codec == compression::none) {
+            Fletcher64 checksum;
+            checksum.update(v.data(), v.size() * sizeof(T));
+            Trailer trailer{static_cast<uint64_t>(v.size() * sizeof(T)), checksum.value()};
+            iovec parts[3] = {{&header, sizeof(header)},
+                {const_cast<void*>(static_cast<const void*>(v.data())), v.size() * sizeof(T)},
+                {&trailer, sizeof(trailer)}};
+            sink.writev(parts, 3);
+            return;
+        }
+    }
+
+    sink.write(&header, sizeof(header));
+    BlockWriter<Sink> writer(sink, options);
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        writer.write(v.data(), v.size() * sizeof(T));
+    }
+    else {
+        for (const T& element : v) {
+            codec<T>::encode(writer, element);
+        }
+    }
+    writer.finish();
+}
+
+template <class Source, typename T, class Alloc, class Growth, size_t N>
+void read_vector(Source& source, Vector<T, Alloc, Growth, N>& v) {
+    Header header;
+    source.read(&header, sizeof(header));
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0) {
+        throw_corrupt("input is not a serialized Vector");
+    }
+    if (header.version != format_version) {
+        throw_corrupt("unsupported format version");
+    }
+    if (header.byte_order != native_order) {
+        throw_corrupt("input was written with a different byte order");
+    }
+    if (header.element_size != sizeof(T)) {
+        throw_corrupt("input was written for a different element size");
+    }
+    compression mode = static_cast<compression>(header.codec);
+    if (mode != compression::none && mode != compression::lz4) {
+        throw_corrupt("unknown compression codec");
+    }
+    if (header.count > SIZE_MAX / sizeof(T)) {
+        throw_corrupt("element count exceeds the addressable range");
+    }
+
+    Vector<T, Alloc, Growth, N> result(v.get_allocator());
+    BlockReader<Source> reader(source, mode);
+    size_t count = static_cast<size_t>(header.count);
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        // read in bounded steps so that a corrupt count fails at end of input instead of allocating it all
+        constexpr size_t step = (size_t(64) << 20) / sizeof(T) + 1;
+        while (result.size() < count) {
+            size_t n = std::min(step, count - result.size());
+            size_t offset = result.size();
+            result.resize_for_overwrite(offset + n);
+            reader.read(result.data() + offset, n * sizeof(T));
+        }
+    }
+    else {
+        result.reserve(std::min<size_t>(count, 4096));
+        for (size_t i = 0; i < count; ++i) {
+            result.push_back(codec<T>::decode(reader));
+        }
+    }
+    reader.finish();
+    v = std::move(result);
+}
+
+}
+
+template <typename T, class Alloc, class Growth, size_t N>
+void write_to(int fd, const Vector<T, Alloc, Growth, N>& v, const write_options& options = {}) {
+    detail::FdSink sink(fd);
+    detail::write_vector(sink, v, options);
+}
+
+template <typename T, class Alloc, class Growth, size_t N>
+void write_to(std::ostream& out, const Vector<T, Alloc, Growth, N>& v, const write_options& options = {}) {
+    detail::StreamSink sink(out);
+    detail::write_vector(sink, v, options);
+}
+
+template <typename T, class Alloc, class Growth, size_t N>
+void read_from(int fd, Vector<T, Alloc, Growth, N>& v) {
+    detail::FdSource source(fd);
+    detail::read_vector(source, v);
+}
+
+template <typename T, class Alloc, class Growth, size_t N>
+void read_from(std::istream& in, Vector<T, Alloc, Growth, N>& v) {
+    detail::StreamSource source(in);
+    detail::read_vector(source, v);
+}
+
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Structure-of-arrays container: every field lives in its own contiguous Vector column, so a scan
+// over one or two fields only pulls those columns through the cache.
+//
+// Each column is a Vector with its own size and capacity, and the container keeps their sizes in
+// step. All columns are grown together by GrowthPolicy, sized by the combined element size. If a
+// later field throws, push_back and resize roll back the columns they already extended; erase and
+// unordered_erase are only available when every field's move assignment is noexcept, so they cannot
+// stop part way. operator[] returns a tuple of references into the columns (usable with structured
+// bindings, std::get and tuple assignment) and column<I>() exposes a field as a span for SIMD
+// kernels. Rows can be appended from the fields, from a tuple, or from an aggregate struct with the
+// same members in the same order.
+namespace soa_detail {
+
+// Unpacks an aggregate with Count members into a tuple of const references.
+template <size_t Count, typename S>
+auto tie_fields(const S& s) {
+    static_assert(Count >= 1 && Count <= 8, "struct push_back supports aggregates with 1 to 8 members");
+    if constexpr (Count == 1) {
+        const auto& [a] = s;
+        return std::tie(a);
+    }
+    else if constexpr (Count == 2) {
+        const auto& [a, b] = s;
+        return std::tie(a, b);
+    }
+    else if constexpr (Count == 3) {
+        const auto& [a, b, c] = s;
+        return std::tie(a, b, c);
+    }
+    else if constexpr (Count == 4) {
+        const auto& [a, b, c, d] = s;
+        return std::tie(a, b, c, d);
+    }
+    else if constexpr (Count == 5) {
+        const auto& [a, b, c, d, e] = s;
+        return std::tie(a, b, c, d, e);
+    }
+    else if constexpr (Count == 6) {
+        const auto& [a, b, c, d, e, f] = s;
+        return std::tie(a, b, c, d, e, f);
+    }
+    else if constexpr (Count == 7) {
+        const auto& [a, b, c, d, e, f, g] = s;
+        return std::tie(a, b, c, d, e, f, g);
+    }
+    else {
+        const auto& [a, b, c, d, e, f, g, h] = s;
+        return std::tie(a, b, c, d, e, f, g, h);
+    }
+}
+
+template <typename T>
+struct is_tuple : std::false_type {};
+
+template <typename... Ts>
+struct is_tuple<std::tuple<Ts...>> : std::true_type {};
+
+}
+
+template <class GrowthPolicy, typename... Fields>
+class BasicSoAVector {
+    static_assert(sizeof...(Fields) > 0, "SoAVector needs at least one field");
+    static_assert(growth_policy<GrowthPolicy>, "GrowthPolicy must provide static next_capacity(capacity, required, elementSize)");
+
+    static constexpr size_t row_size = (sizeof(Fields) + ...);
+
+    // Row erase shifts every column in turn; a throwing move in a later column would leave the
+    // column sizes apart.
+    static constexpr bool nothrow_move_fields = (std::is_nothrow_move_assignable_v<Fields> && ...);
+
+public:
+    using value_type = std::tuple<Fields...>;
+    using reference = std::tuple<Fields&...>;
+    using const_reference = std::tuple<const Fields&...>;
+
+    template <size_t I>
+    using field_type = std::tuple_element_t<I, value_type>;
+
+    static constexpr size_t field_count = sizeof...(Fields);
+
+    BasicSoAVector() = default;
+
+    [[nodiscard]] size_t size() const noexcept {
+        return std::get<0>(columns_).size();
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept {
+        return std::apply([](const auto&... column) { return std::min({column.capacity()...}); }, columns_);
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    template <size_t I>
+    [[nodiscard]] std::span<field_type<I>> column() noexcept {
+        auto& c = std::get<I>(columns_);
+        return {c.data(), c.size()};
+    }
+
+    template <size_t I>
+    [[nodiscard]] std::span<const field_type<I>> column() const noexcept {
+        const auto& c = std::get<I>(columns_);
+        return {c.data(), c.size()};
+    }
+
+    reference operator[](size_t index) noexcept {
+        return std::apply([index](auto&... column) { return reference(column.data()[index]...); }, columns_);
+    }
+
+    const_reference operator[](size_t index) const noexcept {
+        return std::apply([index](const auto&... column) { return const_reference(column.data()[index]...); },
+            columns_);
+    }
+
+    reference at(size_t index) {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range");
+        }
+        return (*this)[index];
+    }
+
+    const_reference at(size_t index) const {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range");
+        }
+        return (*this)[index];
+    }
+
+    reference front() noexcept { return (*this)[0]; }
+    reference back() noexcept { return (*this)[size() - 1]; }
+
+    void reserve(size_t newCapacity) {
+        std::apply([newCapacity](auto&... column) { (column.reserve(newCapacity), ...); }, columns_);
+    }
+
+    template <typename... Args>
+        requires(sizeof...(Args) == sizeof...(Fields))
+    reference emplace_back(Args&&... fields) {
+        if (size() == capacity()) {
+            // fields may refer to a row of this container, which reserve() is about to move
+            value_type row(std::forward<Args>(fields)...);
+            reserve(GrowthPolicy::next_capacity(capacity(), size() + 1, row_size));
+            std::apply([this](auto&... built) { appendRow(std::index_sequence_for<Fields...>{}, std::move(built)...); },
+                row);
+            return back();
+        }
+        appendRow(std::index_sequence_for<Fields...>{}, std::forward<Args>(fields)...);
+        return back();
+    }
+
+    template <typename... Ts>
+    void push_back(const std::tuple<Ts...>& row) {
+        std::apply([this](const auto&... fields) { emplace_back(fields...); }, row);
+    }
+
+    template <typename... Ts>
+    void push_back(std::tuple<Ts...>&& row) {
+        std::apply([this](auto&&... fields) { emplace_back(std::forward<decltype(fields)>(fields)...); },
+            std::move(row));
+    }
+
+    // Appends an aggregate whose members match Fields in order, e.g. struct Particle { float x, y, z; }.
+    template <typename S>
+        requires(std::is_aggregate_v<S> && !soa_detail::is_tuple<S>::value)
+    void push_back(const S& row) {
+        push_back(soa_detail::tie_fields<sizeof...(Fields)>(row));
+    }
+
+    void pop_back() {
+        if (empty()) {
+            throw std::out_of_range("Vector is empty");
+        }
+        std::apply([](auto&... column) { (column.pop_back(), ...); }, columns_);
+    }
+
+    void erase(size_t index)
+        requires(nothrow_move_fields)
+    {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range");
+        }
+        std::apply([index](auto&... column) { (column.erase(index), ...); }, columns_);
+    }
+
+    // Moves the last row into index instead of shifting the rows after it; row order is not kept.
+    void unordered_erase(size_t index)
+        requires(nothrow_move_fields)
+    {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range");
+        }
+        std::apply([index](auto&... column) { (column.unordered_erase(index), ...); }, columns_);
+    }
+
+    // New rows are value-initialized.
+    void resize(size_t count) {
+        if (count > capacity()) {
+            reserve(count);
+        }
+        resizeColumns(std::index_sequence_for<Fields...>{}, count);
+    }
+
+    void clear() noexcept {
+        std::apply([](auto&... column) { (column.clear(), ...); }, columns_);
+    }
+
+    void shrink_to_fit() {
+        std::apply([](auto&... column) { (column.shrink_to_fit(), ...); }, columns_);
+    }
+
+    // Copies row index out into a tuple of values.
+    [[nodiscard]] value_type row(size_t index) const {
+        return value_type((*this)[index]);
+    }
+
+private:
+    // Appends one field per column; if a later field throws, the columns already extended are rolled back.
+    template <size_t... I, typename... Args>
+    void appendRow(std::index_sequence<I...>, Args&&... fields) {
+        size_t appended = 0;
+        try {
+            ((std::get<I>(columns_).emplace_back(std::forward<Args>(fields)), ++appended), ...);
+        }
+        catch (...) {
+            ((I < appended ? std::get<I>(columns_).pop_back() : void()), ...);
+            throw;
+        }
+    }
+
+    // Resizes one column at a time; if a later column throws, the columns already resized go back to the old size.
+    template <size_t... I>
+    void resizeColumns(std::index_sequence<I...>, size_t count) {
+        size_t oldSize = size();
+        size_t resized = 0;
+        try {
+            ((std::get<I>(columns_).resize(count), ++resized), ...);
+        }
+        catch (...) {
+            ((I < resized ? std::get<I>(columns_).resize(oldSize) : void()), ...);
+            throw;
+        }
+    }
+
+    std::tuple<Vector<Fields, std::allocator<Fields>, GrowthPolicy>...> columns_;
+};
+
+template <typename... Fields>
+using SoAVector = BasicSoAVector<DefaultGrowth, Fields...>;
@@ -0,0 +1,534 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Vector with a fixed capacity of N elements stored inside the object, like C++26 std::inplace_vector.
+//
+// It never allocates: growing past N throws std::length_error, and try_push_back/try_emplace_back
+// return a pointer to the new element, or nullptr when the StaticVector is full. The API, the iterator
+// types and the insert/erase/search algorithms are Vector's (see vector_detail in vector.h), so
+// switching a declaration between Vector<T> and StaticVector<T, N> is all it takes as long as the size
+// stays within N. When T is trivially copyable, so is StaticVector<T, N>: it can be memcpy'd into a
+// message slot or shared memory as a whole. Copies always cover all N slots in that case.
+// Moving leaves the source with its moved-from elements, as std::inplace_vector does.
+template <typename T, size_t N>
+class StaticVector {
+    static_assert(N > 0, "StaticVector needs room for at least one element");
+
+    union {
+        T elements_[N];
+    };
+    size_t size_;
+
+    // Iterators point at non-const T and carry constness in their type, as Vector's do.
+    T* base() const noexcept {
+        return const_cast<T*>(elements_);
+    }
+
+    VECTOR_COLD [[noreturn]] static void overflow() {
+        throw std::length_error("StaticVector capacity exceeded");
+    }
+
+    static void check_room(size_t count) {
+        if (count > N) {
+            overflow();
+        }
+    }
+
+    static constexpr auto constructor() noexcept {
+        return [](T* where, auto&&... args) { std::construct_at(where, std::forward<decltype(args)>(args)...); };
+    }
+
+    static constexpr auto destroyer() noexcept {
+        return [](T* where) { std::destroy_at(where); };
+    }
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+
+    using Iterator = typename Vector<T>::Iterator;
+    using ConstIterator = typename Vector<T>::ConstIterator;
+    using RIterator = std::reverse_iterator<Iterator>;
+    using ConstRIterator = std::reverse_iterator<ConstIterator>;
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    StaticVector() noexcept : size_(0) {}
+
+    StaticVector(size_t count, const T& value) : size_(0) {
+        check_room(count);
+        std::uninitialized_fill_n(elements_, count, value);
+        size_ = count;
+    }
+
+    explicit StaticVector(size_t count) : size_(0) {
+        check_room(count);
+        std::uninitialized_value_construct_n(elements_, count);
+        size_ = count;
+    }
+
+    StaticVector(std::initializer_list<T> init) : size_(0) {
+        check_room(init.size());
+        std::uninitialized_copy_n(init.begin(), init.size(), elements_);
+        size_ = init.size();
+    }
+
+    StaticVector(const StaticVector&)
+        requires std::is_trivially_copy_constructible_v<T> && std::is_trivially_destructible_v<T> = default;
+
+    StaticVector(const StaticVector& other) : size_(0) {
+        std::uninitialized_copy_n(other.elements_, other.size_, elements_);
+        size_ = other.size_;
+    }
+
+    StaticVector(StaticVector&&)
+        requires std::is_trivially_move_constructible_v<T> && std::is_trivially_destructible_v<T> = default;
+
+    StaticVector(StaticVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : size_(0) {
+        std::uninitialized_move_n(other.elements_, other.size_, elements_);
+        size_ = other.size_;
+    }
+
+    StaticVector& operator=(const StaticVector&) requires std::is_trivially_copy_assignable_v<T>
+        && std::is_trivially_copy_constructible_v<T> && std::is_trivially_destructible_v<T> = default;
+
+    StaticVector& operator=(const StaticVector& other) {
+        if (this != &other) {
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    StaticVector& operator=(StaticVector&&) requires std::is_trivially_move_assignable_v<T>
+        && std::is_trivially_move_constructible_v<T> && std::is_trivially_destructible_v<T> = default;
+
+    StaticVector& operator=(StaticVector&& other) noexcept(std::is_nothrow_move_assignable_v<T>
+        && std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            if (other.size_ > size_) {
+                std::move(other.elements_, other.elements_ + size_, elements_);
+                std::uninitialized_move(other.elements_ + size_, other.elements_ + other.size_, elements_ + size_);
+            }
+            else {
+                std::move(other.elements_, other.elements_ + other.size_, elements_);
+                std::destroy(elements_ + other.size_, elements_ + size_);
+            }
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    ~StaticVector() requires std::is_trivially_destructible_v<T> = default;
+
+    ~StaticVector() {
+        std::destroy_n(elements_, size_);
+    }
+
+    void swap(StaticVector& other) noexcept(std::is_nothrow_swappable_v<T> && std::is_nothrow_move_constructible_v<T>) {
+        if (this == &other) {
+            return;
+        }
+        StaticVector& shorter = size_ < other.size_ ? *this : other;
+        StaticVector& longer = size_ < other.size_ ? other : *this;
+        std::swap_ranges(shorter.elements_, shorter.elements_ + shorter.size_, longer.elements_);
+        std::uninitialized_move(longer.elements_ + shorter.size_, longer.elements_ + longer.size_,
+            shorter.elements_ + shorter.size_);
+        std::destroy(longer.elements_ + shorter.size_, longer.elements_ + longer.size_);
+        std::swap(size_, other.size_);
+    }
+
+    Iterator begin() noexcept { return Iterator(base()); }
+    Iterator end() noexcept { return Iterator(base() + size_); }
+
+    ConstIterator begin() const noexcept { return ConstIterator(base()); }
+    ConstIterator end() const noexcept { return ConstIterator(base() + size_); }
+
+    ConstIterator cbegin() const noexcept { return begin(); }
+    ConstIterator cend() const noexcept { return end(); }
+
+    // Built over end()/begin() so that no pointer before the storage is ever formed.
+    RIterator rbegin() noexcept { return RIterator(end()); }
+    RIterator rend() noexcept { return RIterator(begin()); }
+
+    ConstRIterator rbegin() const noexcept { return ConstRIterator(end()); }
+    ConstRIterator rend() const noexcept { return ConstRIterator(begin()); }
+
+    ConstRIterator crbegin() const noexcept { return rbegin(); }
+    ConstRIterator crend() const noexcept { return rend(); }
+
+    // Nothing to allocate; only checks that newCapacity fits.
+    void reserve(size_t newCapacity) {
+        check_room(newCapacity);
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        if (size_ == N) {
+            overflow();
+        }
+        std::construct_at(elements_ + size_, std::forward<Args>(args)...);
+        ++size_;
+    }
+
+    // Appends unless the StaticVector is full; returns the new element, or nullptr when there was no room.
+    template <typename... Args>
+    T* try_emplace_back(Args&&... args) {
+        if (size_ == N) {
+            return nullptr;
+        }
+        T* element = std::construct_at(elements_ + size_, std::forward<Args>(args)...);
+        ++size_;
+        return element;
+    }
+
+    T* try_push_back(const T& value) {
+        return try_emplace_back(value);
+    }
+
+    T* try_push_back(T&& value) {
+        return try_emplace_back(std::move(value));
+    }
+
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    void push_back(std::initializer_list<T>&& init) {
+        append_range(init);
+    }
+
+    template <std::ranges::input_range R>
+    void append_range(R&& range) {
+        if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>) {
+            size_t count = static_cast<size_t>(std::ranges::distance(range));
+            check_room(size_ + count);
+            std::uninitialized_copy_n(std::ranges::begin(range), count, elements_ + size_);
+            size_ += count;
+        }
+        else {
+            for (auto&& element : range) {
+                emplace_back(std::forward<decltype(element)>(element));
+            }
+        }
+    }
+
+    template <std::ranges::input_range R>
+    void insert_range(size_t index, R&& range) {
+        if (index > size_) {
+            vector_check::throw_out_of_range(index, size_);
+        }
+        size_t oldSize = size_;
+        append_range(std::forward<R>(range));
+        std::rotate(elements_ + index, elements_ + oldSize, elements_ + size_);
+    }
+
+    template <std::ranges::input_range R>
+    void insert_range(Iterator pos, R&& range) {
+        insert_range(static_cast<size_t>(pos - begin()), std::forward<R>(range));
+    }
+
+    template <std::input_iterator It>
+    void assign(It first, It last) {
+        clear();
+        append_range(std::ranges::subrange(first, last));
+    }
+
+    void assign(size_t count, const T& value) {
+        check_room(count);
+        T copy = value;
+        clear();
+        resize(count, copy);
+    }
+
+    void assign(std::initializer_list<T> init) {
+        copy_from(init);
+    }
+
+    // Copy-assigns from any contiguous source, which may point into this StaticVector.
+    void copy_from(std::span<const T> source) {
+        size_t count = source.size();
+        check_room(count);
+        if (count > size_) {
+            std::copy_n(source.data(), size_, elements_);
+            std::uninitialized_copy_n(source.data() + size_, count - size_, elements_ + size_);
+        }
+        else {
+            std::copy_n(source.data(), count, elements_);
+            std::destroy_n(elements_ + count, size_ - count);
+        }
+        size_ = count;
+    }
+
+    void resize(size_t count) {
+        if (count < size_) {
+            std::destroy_n(elements_ + count, size_ - count);
+        }
+        else {
+            check_room(count);
+            std::uninitialized_value_construct_n(elements_ + size_, count - size_);
+        }
+        size_ = count;
+    }
+
+    void resize(size_t count, const T& value) {
+        if (count < size_) {
+            std::destroy_n(elements_ + count, size_ - count);
+        }
+        else {
+            check_room(count);
+            std::uninitialized_fill_n(elements_ + size_, count - size_, value);
+        }
+        size_ = count;
+    }
+
+    // Like resize(count), but new elements are default-initialized: trivial types are left
+    // uninitialized for the caller to overwrite.
+    void resize_for_overwrite(size_t count) {
+        if (count < size_) {
+            std::destroy_n(elements_ + count, size_ - count);
+        }
+        else {
+            check_room(count);
+            std::uninitialized_default_construct_n(elements_ + size_, count - size_);
+        }
+        size_ = count;
+    }
+
+    // Lets write(dest, count) fill up to count elements past the end, as Vector::append_uninitialized does.
+    template <typename Fn>
+        requires std::is_invocable_r_v<size_t, Fn&, T*, size_t>
+    size_t append_uninitialized(size_t count, Fn&& write) {
+        static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+            "append_uninitialized requires a trivial element type");
+
+        check_room(size_ + count);
+        size_t written = std::invoke(write, elements_ + size_, count);
+        if (written > count) {
+            throw std::length_error("append_uninitialized callback reported more elements than requested");
+        }
+        size_ += written;
+        return written;
+    }
+
+    void pop_back() noexcept {
+        VECTOR_CHECK(size_ > 0, "pop_back() on an empty StaticVector", 0, size_);
+        --size_;
+        std::destroy_at(elements_ + size_);
+    }
+
+    reference operator[](size_t index) noexcept {
+        VECTOR_CHECK(index < size_, "operator[] index out of range", index, size_);
+        return elements_[index];
+    }
+
+    const_reference operator[](size_t index) const noexcept {
+        VECTOR_CHECK(index < size_, "operator[] index out of range", index, size_);
+        return elements_[index];
+    }
+
+    reference back() noexcept {
+        VECTOR_CHECK(size_ > 0, "back() on an empty StaticVector", 0, size_);
+        return elements_[size_ - 1];
+    }
+
+    const_reference back() const noexcept {
+        VECTOR_CHECK(size_ > 0, "back() on an empty StaticVector", 0, size_);
+        return elements_[size_ - 1];
+    }
+
+    [[nodiscard]] T& at(size_t index) {
+        if (index >= size_) {
+            vector_check::throw_out_of_range(index, size_);
+        }
+        return elements_[index];
+    }
+
+    [[nodiscard]] const T& at(size_t index) const {
+        if (index >= size_) {
+            vector_check::throw_out_of_range(index, size_);
+        }
+        return elements_[index];
+    }
+
+    bool find(const T& element) const {
+        return index(element) != npos;
+    }
+
+    bool contains(const T& element) const {
+        return index(element) != npos;
+    }
+
+    // Position of the first occurrence of element, or npos.
+    size_t index(const T& element) const {
+        return vector_detail::index(elements_, size_, element);
+    }
+
+    // Position of the last occurrence of element, or npos.
+    size_t rfind(const T& element) const {
+        return vector_detail::rfind(elements_, size_, element);
+    }
+
+    size_t count(const T& element) const {
+        return vector_detail::count(elements_, size_, element);
+    }
+
+    void insert(const T& element, size_t index) {
+        if (index > size_) {
+            vector_check::throw_out_of_range(index, size_);
+        }
+        if (size_ == N) {
+            overflow();
+        }
+        vector_detail::insert_one(elements_, size_, index, element, constructor());
+        ++size_;
+    }
+
+    void insert(const T& element, Iterator pos) {
+        auto index = std::distance(begin(), pos);
+
+        if (index < 0 || static_cast<size_t>(index) > size_) {
+            vector_check::throw_out_of_range(static_cast<size_t>(index), size_);
+        }
+        insert(element, static_cast<size_t>(index));
+    }
+
+    void erase(size_t index) {
+        if (index >= size_) {
+            vector_check::throw_out_of_range("Index out of range");
+        }
+        vector_detail::erase_range(elements_, size_, index, index + 1);
+        --size_;
+    }
+
+    Iterator erase(Iterator pos) {
+        VECTOR_CHECK(pos >= begin() && pos < end(), "erase() iterator out of range", pos - begin(), size_);
+        size_t index = static_cast<size_t>(pos - begin());
+        vector_detail::erase_range(elements_, size_, index, index + 1);
+        --size_;
+        return begin() + static_cast<std::ptrdiff_t>(index);
+    }
+
+    size_t erase(size_t first_index, size_t last_index) {
+        if (first_index > last_index || last_index > size_) {
+            vector_check::throw_out_of_range("Invalid index range");
+        }
+        vector_detail::erase_range(elements_, size_, first_index, last_index);
+        size_ -= last_index - first_index;
+        return first_index;
+    }
+
+    Iterator erase(Iterator first, Iterator last) {
+        VECTOR_CHECK(first >= begin() && first <= last && last <= end(), "erase() iterator range out of bounds",
+            first - begin(), size_);
+
+        size_t index = static_cast<size_t>(first - begin());
+        size_t lastIndex = static_cast<size_t>(last - begin());
+        vector_detail::erase_range(elements_, size_, index, lastIndex);
+        size_ -= lastIndex - index;
+        return begin() + static_cast<std::ptrdiff_t>(index);
+    }
+
+    // O(1) erase that does not preserve order: the last element takes the place of the erased one.
+    void unordered_erase(size_t index) {
+        if (index >= size_) {
+            vector_check::throw_out_of_range("Index out of range");
+        }
+        vector_detail::unordered_erase(elements_, size_, index, destroyer());
+        --size_;
+    }
+
+    // Removes every element matching pred in a single pass and returns how many were removed.
+    template <typename Pred>
+    size_t erase_if(Pred pred) {
+        return vector_detail::erase_if(elements_, size_, pred, destroyer());
+    }
+
+    // Removes the elements at the given strictly increasing indices, compacting the rest in one sweep.
+    void erase_indices(std::span<const size_t> indices) {
+        vector_detail::erase_indices(elements_, size_, indices, destroyer());
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    [[nodiscard]] bool full() const noexcept {
+        return size_ == N;
+    }
+
+    void clear() noexcept {
+        std::destroy_n(elements_, size_);
+        size_ = 0;
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return size_;
+    }
+
+    [[nodiscard]] static constexpr size_t capacity() noexcept {
+        return N;
+    }
+
+    [[nodiscard]] T* data() noexcept {
+        return elements_;
+    }
+
+    [[nodiscard]] const T* data() const noexcept {
+        return elements_;
+    }
+
+    operator std::span<T>() noexcept {
+        return {elements_, size_};
+    }
+
+    operator std::span<const T>() const noexcept {
+        return {elements_, size_};
+    }
+
+    // count elements starting at first, without copying.
+    [[nodiscard]] VectorView<T> slice(size_t first, size_t count) {
+        return VectorView<T>(elements_, size_).slice(first, count);
+    }
+
+    [[nodiscard]] VectorView<const T> slice(size_t first, size_t count) const {
+        return VectorView<const T>(elements_, size_).slice(first, count);
+    }
+
+    // Every stride-th element starting at first.
+    [[nodiscard]] StridedView<T> strided(size_t first, size_t stride) {
+        return VectorView<T>(elements_, size_).strided(first, stride);
+    }
+
+    [[nodiscard]] StridedView<const T> strided(size_t first, size_t stride) const {
+        return VectorView<const T>(elements_, size_).strided(first, stride);
+    }
+
+    // The storage cannot shrink; kept so code written against Vector compiles unchanged.
+    void shrink_to_fit() noexcept {}
+};
+
+// The elements are stored inline with no pointers into the object, so the StaticVector relocates
+// exactly when its elements do.
+template <typename T, size_t N>
+struct is_trivially_relocatable<StaticVector<T, N>> : std::bool_constant<is_trivially_relocatable_v<T>> {};
@@ -2,72 +2,683 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
 #include <cstddef>
-#include <format>
+#include <functional>
+#include <cstring>
 #include <initializer_list>
-#include <iostream>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <utility>
-using namespace std;
 
-template <typename T, class Alloc = allocator<T>>
+#include "vector_check.h"
+#include "vector_simd.h"
+#include "vector_stats.h"
+#include "vector_view.h"
+
+// Opt-in customization point: a type is trivially relocatable when moving it to a new
+// address and ending the lifetime of the source is equivalent to copying its bytes.
+// Specialize for your own types, e.g.
+//     template <> struct is_trivially_relocatable<Handle> : std::true_type {};
+// Note that std::string is not relocatable this way in libstdc++ (its SSO buffer is self-referential).
+template <typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template <typename T, typename D>
+struct is_trivially_relocatable<std::unique_ptr<T, D>>
+    : std::bool_constant<is_trivially_relocatable<D>::value> {};
+
+template <typename T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+// Optional allocator extensions, probed by Vector before falling back to allocate/copy/deallocate:
+//     bool try_expand(T* p, size_t oldCount, size_t newCount)  - grow the block in place, never moves it
+//     T*   reallocate(T* p, size_t oldCount, size_t newCount)  - resize the block, possibly moving its bytes;
+//                                                              only used for trivially relocatable T
+template <typename Alloc, typename T>
+concept allocator_can_expand = requires(Alloc& alloc, T* p, size_t n) {
+    { alloc.try_expand(p, n, n) } -> std::convertible_to<bool>;
+};
+
+template <typename Alloc, typename T>
+concept allocator_can_reallocate = requires(Alloc& alloc, T* p, size_t n) {
+    { alloc.reallocate(p, n, n) } -> std::convertible_to<T*>;
+};
+
+// Growth policies decide the capacity of the next allocation once a Vector runs out of room:
+//     static size_t next_capacity(size_t capacity, size_t required, size_t elementSize)
+// The result must be at least required; Vector clamps it to the allocator's max_size.
+template <typename Policy>
+concept growth_policy = requires(size_t n) {
+    { Policy::next_capacity(n, n, n) } -> std::convertible_to<size_t>;
+};
+
+// Multiplies the capacity by Num/Den, always adding at least one element.
+template <size_t Num, size_t Den>
+struct FactorGrowth {
+    static_assert(Num > Den, "growth factor must be greater than 1");
+
+    static constexpr size_t next_capacity(size_t capacity, size_t required, size_t) noexcept {
+        size_t grown = capacity / Den * Num + capacity % Den * Num / Den;
+        if (grown < capacity + 1) {
+            grown = capacity + 1;
+        }
+        return std::max(grown, required);
+    }
+};
+
+using DefaultGrowth = FactorGrowth<3, 2>;
+using GoldenRatioGrowth = FactorGrowth<1618, 1000>;
+using DoublingGrowth = FactorGrowth<2, 1>;
+using ConservativeGrowth = FactorGrowth<5, 4>;
+
+// Sizes the first allocation of an empty Vector to at least First elements, then defers to Base.
+template <size_t First, class Base = DefaultGrowth>
+struct FirstGrowthHint {
+    static constexpr size_t next_capacity(size_t capacity, size_t required, size_t elementSize) noexcept {
+        if (capacity == 0) {
+            return std::max(First, required);
+        }
+        return Base::next_capacity(capacity, required, elementSize);
+    }
+};
+
+// Rounds the capacity chosen by Base up so the allocation fills whole pages.
+template <class Base = DefaultGrowth, size_t PageSize = 4096>
+struct PageRoundedGrowth {
+    static_assert((PageSize & (PageSize - 1)) == 0, "page size must be a power of two");
+
+    static constexpr size_t next_capacity(size_t capacity, size_t required, size_t elementSize) noexcept {
+        size_t bytes = Base::next_capacity(capacity, required, elementSize) * elementSize;
+        return ((bytes + PageSize - 1) & ~(PageSize - 1)) / elementSize;
+    }
+};
+
+// PageRoundedGrowth for huge pages, applied only from Threshold bytes up so that small Vectors are not
+// padded to a full huge page; meant for HugePageAllocator (allocators.h) with the same parameters.
+template <class Base = DefaultGrowth, size_t PageSize = size_t(2) << 20, size_t Threshold = PageSize>
+struct HugePageGrowth {
+    static constexpr size_t next_capacity(size_t capacity, size_t required, size_t elementSize) noexcept {
+        size_t bytes = Base::next_capacity(capacity, required, elementSize) * elementSize;
+        if (bytes < Threshold) {
+            return bytes / elementSize;
+        }
+        return ((bytes + PageSize - 1) & ~(PageSize - 1)) / elementSize;
+    }
+};
+
+// Rounds the capacity chosen by Base up to jemalloc's size classes (8, 16, 32, 48, 64, 80, ...,
+// four classes per power of two), so the slack jemalloc would hand out anyway becomes usable capacity.
+template <class Base = DefaultGrowth>
+struct JemallocGrowth {
+    static constexpr size_t size_class(size_t bytes) noexcept {
+        if (bytes <= 8) {
+            return 8;
+        }
+        if (bytes <= 16) {
+            return 16;
+        }
+        size_t lg = std::bit_width(bytes - 1) - 1;
+        size_t delta = std::max<size_t>(16, size_t(1) << (lg - 2));
+        return (bytes + delta - 1) & ~(delta - 1);
+    }
+
+    static constexpr size_t next_capacity(size_t capacity, size_t required, size_t elementSize) noexcept {
+        size_t bytes = Base::next_capacity(capacity, required, elementSize) * elementSize;
+        return size_class(bytes) / elementSize;
+    }
+};
+
+// Grows like Base and turns on Vector's counters (vector_stats.h) under the label Site. Keep it the
+// outermost policy: wrappers such as FirstGrowthHint only forward next_capacity.
+template <class Base = DefaultGrowth, vector_stats::site_name Site = "">
+struct InstrumentedGrowth {
+    using instrumentation = CountingInstrumentation<Site>;
+
+    static constexpr size_t next_capacity(size_t capacity, size_t required, size_t elementSize) noexcept {
+        return Base::next_capacity(capacity, required, elementSize);
+    }
+};
+
+// Alignment an allocator guarantees for its blocks: Alloc::alignment when it advertises one, alignof(T) otherwise.
+template <typename Alloc, typename T>
+inline constexpr size_t allocator_alignment = alignof(T);
+
+template <typename Alloc, typename T>
+    requires requires { { Alloc::alignment } -> std::convertible_to<size_t>; }
+inline constexpr size_t allocator_alignment<Alloc, T> = std::max(alignof(T), static_cast<size_t>(Alloc::alignment));
+
+// Element storage embedded in SmallVector; empty (and zero-sized as a member) for plain Vector.
+template <typename T, size_t N, size_t Align = alignof(T)>
+struct InlineBuffer {
+    alignas(Align) unsigned char bytes[N * sizeof(T)];
+
+    T* data() noexcept { return reinterpret_cast<T*>(bytes); }
+    const T* data() const noexcept { return reinterpret_cast<const T*>(bytes); }
+};
+
+template <typename T, size_t Align>
+struct InlineBuffer<T, 0, Align> {
+    constexpr T* data() noexcept { return nullptr; }
+    constexpr const T* data() const noexcept { return nullptr; }
+};
+
+// Element algorithms shared by Vector and StaticVector (static_vector.h). They work on data[0, size) of
+// constructed elements with room for one more where they insert; callers update their own size unless a
+// function takes it by reference. construct(where, args...) and destroy(where) build and end one element
+// the way the container does, i.e. through the allocator for Vector.
+namespace vector_detail {
+
+// Whether p points into [first, last). Constant evaluation does not allow ordering pointers into
+// different objects, so there it looks for p one element at a time.
+template <typename T>
+constexpr bool points_into(const T* p, const T* first, const T* last) noexcept {
+    if (std::is_constant_evaluated()) {
+        for (; first != last; ++first) {
+            if (first == p) {
+                return true;
+            }
+        }
+        return false;
+    }
+    return p >= first && p < last;
+}
+
+// Shifts [index, size) one slot to the right and copies element into the gap.
+template <typename T, typename Construct>
+constexpr void insert_one(T* data, size_t size, size_t index, const T& element, Construct&& construct) {
+    if (index == size) {
+        construct(data + size, element);
+        return;
+    }
+
+    // element may live in the tail that is about to shift one slot to the right
+    const T* source = std::addressof(element);
+    if (points_into(source, data + index, data + size)) {
+        ++source;
+    }
+
+    if constexpr (is_trivially_relocatable_v<T>) {
+        if (!std::is_constant_evaluated()) {
+            size_t tail = (size - index) * sizeof(T);
+            std::memmove(static_cast<void*>(data + index + 1), static_cast<const void*>(data + index), tail);
+            try {
+                construct(data + index, *source);
+            }
+            catch (...) {
+                std::memmove(static_cast<void*>(data + index), static_cast<const void*>(data + index + 1), tail);
+                throw;
+            }
+            return;
+        }
+    }
+    construct(data + size, std::move(data[size - 1]));
+    std::move_backward(data + index, data + size - 1, data + size);
+    data[index] = *source;
+}
+
+// Removes [first, last) and closes the gap; the caller subtracts last - first from its size.
+template <typename T>
+constexpr void erase_range(T* data, size_t size, size_t first, size_t last) {
+    size_t count = last - first;
+    if (count == 0) {
+        return;
+    }
+
+    if (is_trivially_relocatable_v<T> && !std::is_constant_evaluated()) {
+        std::destroy_n(data + first, count);
+        std::memmove(static_cast<void*>(data + first), static_cast<const void*>(data + last), (size - last) * sizeof(T));
+    }
+    else {
+        std::move(data + last, data + size, data + first);
+        std::destroy_n(data + size - count, count);
+    }
+}
+
+// Moves the last element into index; the caller decrements its size.
+template <typename T, typename Destroy>
+constexpr void unordered_erase(T* data, size_t size, size_t index, Destroy&& destroy) {
+    T* last = data + size - 1;
+    if (is_trivially_relocatable_v<T> && !std::is_constant_evaluated()) {
+        destroy(data + index);
+        if (data + index != last) {
+            std::memcpy(static_cast<void*>(data + index), static_cast<const void*>(last), sizeof(T));
+        }
+    }
+    else {
+        if (data + index != last) {
+            data[index] = std::move(*last);
+        }
+        destroy(last);
+    }
+}
+
+template <typename T, typename Pred, typename Destroy>
+constexpr size_t erase_if(T* data, size_t& size, Pred& pred, Destroy&& destroy) {
+    if (is_trivially_relocatable_v<T> && !std::is_constant_evaluated()) {
+        size_t write = 0;
+        size_t read = 0;
+        try {
+            for (; read < size; ++read) {
+                if (pred(std::as_const(data[read]))) {
+                    destroy(data + read);
+                }
+                else {
+                    if (write != read) {
+                        std::memcpy(static_cast<void*>(data + write), static_cast<const void*>(data + read), sizeof(T));
+                    }
+                    ++write;
+                }
+            }
+        }
+        catch (...) {
+            // close the gap so the elements not yet visited stay part of the container
+            std::memmove(static_cast<void*>(data + write), static_cast<const void*>(data + read),
+                (size - read) * sizeof(T));
+            size = write + (size - read);
+            throw;
+        }
+        size_t removed = size - write;
+        size = write;
+        return removed;
+    }
+    else {
+        T* newEnd = std::remove_if(data, data + size, [&](const T& element) { return pred(element); });
+        size_t removed = static_cast<size_t>(data + size - newEnd);
+        std::destroy_n(newEnd, removed);
+        size -= removed;
+        return removed;
+    }
+}
+
+template <typename T, typename Destroy>
+constexpr void erase_indices(T* data, size_t& size, std::span<const size_t> indices, Destroy&& destroy) {
+    if (indices.empty()) {
+        return;
+    }
+    for (size_t i = 0; i < indices.size(); ++i) {
+        if (indices[i] >= size || (i > 0 && indices[i] <= indices[i - 1])) {
+            vector_check::throw_out_of_range("erase_indices requires strictly increasing indices within the Vector");
+        }
+    }
+
+    bool bytewise = is_trivially_relocatable_v<T> && !std::is_constant_evaluated();
+    size_t write = indices[0];
+    for (size_t k = 0; k < indices.size(); ++k) {
+        size_t first = indices[k] + 1;
+        size_t last = k + 1 < indices.size() ? indices[k + 1] : size;
+        if (bytewise) {
+            destroy(data + indices[k]);
+            std::memmove(static_cast<void*>(data + write), static_cast<const void*>(data + first),
+                (last - first) * sizeof(T));
+            write += last - first;
+        }
+        else {
+            write = static_cast<size_t>(std::move(data + first, data + last, data + write) - data);
+        }
+    }
+
+    if (!bytewise) {
+        std::destroy_n(data + write, size - write);
+    }
+    size = write;
+}
+
+}
+
+// Vector is usable in constant expressions like C++20 std::vector, as long as InlineCapacity is 0 and the
+// allocator is constexpr (std::allocator is). Under std::is_constant_evaluated() the memcpy/memmove and
+// std::uninitialized_* fast paths give way to element-wise construction with std::construct_at.
+template <typename T, class Alloc = std::allocator<T>, growth_policy GrowthPolicy = DefaultGrowth, size_t InlineCapacity = 0>
 class Vector {
 private:
     size_t capacity_;
     size_t size_;
     T* data_;
     [[no_unique_address]] Alloc alloc_;
+    [[no_unique_address]] InlineBuffer<T, InlineCapacity, allocator_alignment<Alloc, T>> inline_;
+
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using Stats = typename instrumentation_of<GrowthPolicy>::type::template hooks<T>;
+
+    constexpr bool is_inline() const noexcept {
+        if constexpr (InlineCapacity == 0) {
+            return false;
+        }
+        else {
+            return data_ == inline_.data();
+        }
+    }
 
-    using AllocTraits = allocator_traits<Alloc>;
+    // Points data_ at room for count elements: the inline buffer when it is large enough, the heap otherwise.
+    constexpr void allocate_storage(size_t count) {
+        if (count <= InlineCapacity) {
+            data_ = inline_.data();
+            capacity_ = InlineCapacity;
+            return;
+        }
+        check_size(count);
+        data_ = AllocTraits::allocate(alloc_, count);
+        capacity_ = count;
+        Stats::allocated(count);
+    }
 
-    void clearMemory() noexcept {
-        if (data_) {
-            std::destroy_n(data_, size_);
+    // Releases the buffer without destroying its elements and falls back to the inline buffer.
+    constexpr void deallocate_storage() noexcept {
+        if (data_ && !is_inline()) {
             AllocTraits::deallocate(alloc_, data_, capacity_);
-            data_ = nullptr;
-            size_ = 0;
-            capacity_ = 0;
+            Stats::deallocated();
         }
+        data_ = inline_.data();
+        capacity_ = InlineCapacity;
     }
 
-    void resize(size_t newCapacity) {
-        size_t newCap = std::max(newCapacity, capacity_ == 0 ? 1 : capacity_ + (capacity_ >> 1) + 1);
-        T* newData = AllocTraits::allocate(alloc_, newCap);
-        size_t oldSize = size_;
+    constexpr void clearMemory() noexcept {
+        if (data_ && !is_inline()) {
+            Stats::retired(capacity_, size_);
+        }
+        std::destroy_n(data_, size_);
+        size_ = 0;
+        deallocate_storage();
+    }
 
-        if constexpr (std::is_trivially_copyable_v<T>) {
-            if (size_ > 0) {
-                memcpy(newData, data_, oldSize);
+    // allocator_traits::construct only differs from placement construction when Alloc provides construct,
+    // as polymorphic_allocator does to pass its resource on to nested containers.
+    static constexpr bool plain_construct = !requires(Alloc& alloc, T* p, const T& value) { alloc.construct(p, value); };
+
+    // allocator_traits::construct can only value-initialize, so default-initialization bypasses it where
+    // that changes nothing: when Alloc has no construct, or for polymorphic_allocator with a T that takes
+    // no allocator, where construct is plain placement construction.
+    static constexpr bool plain_default_construct = plain_construct
+        || (std::is_same_v<Alloc, std::pmr::polymorphic_allocator<T>> && !std::uses_allocator_v<T, Alloc>);
+
+    // Constructs count elements with make(where, i), destroying the ones already built if one throws.
+    template <typename Make>
+    static constexpr void construct_each(T* dest, size_t count, Make&& make) {
+        size_t i = 0;
+        try {
+            for (; i < count; ++i) {
+                make(dest + i, i);
             }
         }
-        else {
-            try {
-                uninitialized_move_n(data_, size_, newData);
+        catch (...) {
+            std::destroy_n(dest, i);
+            throw;
+        }
+    }
+
+    // Moves count elements from first into uninitialized dest and ends their lifetime at the source.
+    constexpr void relocate(T* first, size_t count, T* dest) {
+        Stats::moved(count);
+        if (!std::is_constant_evaluated()) {
+            if constexpr (is_trivially_relocatable_v<T>) {
+                if (count > 0) {
+                    std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), count * sizeof(T));
+                }
+                return;
             }
-            catch (...) {
-                AllocTraits::deallocate(alloc_, data_, oldSize);
-                throw;
+            else if constexpr (plain_construct) {
+                std::uninitialized_move_n(first, count, dest);
+                std::destroy_n(first, count);
+                return;
             }
         }
+        construct_each(dest, count, [&](T* where, size_t i) { create_object(where, std::move(first[i])); });
+        std::destroy_n(first, count);
+    }
+
+    // Grows or shrinks the block through the allocator extensions without an allocate/copy/free cycle.
+    constexpr bool reallocate_in_place(size_t newCap) {
+        if (!data_ || is_inline()) {
+            return false;
+        }
+        if constexpr (allocator_can_expand<Alloc, T>) {
+            if (newCap > capacity_ && alloc_.try_expand(data_, capacity_, newCap)) {
+                capacity_ = newCap;
+                Stats::allocated(newCap);
+                return true;
+            }
+        }
+        if constexpr (allocator_can_reallocate<Alloc, T> && is_trivially_relocatable_v<T>) {
+            if (T* newData = alloc_.reallocate(data_, capacity_, newCap)) {
+                data_ = newData;
+                capacity_ = newCap;
+                Stats::allocated(newCap);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Capacity to grow to so that at least required elements fit.
+    constexpr size_t grow_capacity(size_t required) const {
+        check_size(required);
+        size_t newCap = GrowthPolicy::next_capacity(capacity_, required, sizeof(T));
+        return std::max(required, std::min(newCap, static_cast<size_t>(AllocTraits::max_size(alloc_))));
+    }
+
+    constexpr void grow(size_t required) {
+        reallocate_storage(grow_capacity(required));
+    }
+
+    constexpr void reallocate_storage(size_t newCap) {
+        if (reallocate_in_place(newCap)) {
+            return;
+        }
+
+        T* newData = AllocTraits::allocate(alloc_, newCap);
+        Stats::allocated(newCap);
+
+        try {
+            relocate(data_, size_, newData);
+        }
+        catch (...) {
+            AllocTraits::deallocate(alloc_, newData, newCap);
+            Stats::deallocated();
+            throw;
+        }
 
-        clearMemory();
+        if (data_ && !is_inline()) {
+            AllocTraits::deallocate(alloc_, data_, capacity_);
+            Stats::deallocated();
+        }
+        data_ = newData;
+        capacity_ = newCap;
+    }
+
+    // Growth path of emplace_back. args may refer into the current buffer, so the new element is built
+    // before that buffer is released.
+    template <typename... Args>
+    constexpr void emplace_back_grow(Args&&... args) {
+        if constexpr (allocator_can_reallocate<Alloc, T> && is_trivially_relocatable_v<T>) {
+            // reallocate() may move the block underneath args
+            T value = std::make_obj_using_allocator<T>(alloc_, std::forward<Args>(args)...);
+            grow(size_ + 1);
+            create_object(data_ + size_, std::move(value));
+            ++size_;
+        }
+        else {
+            grow_construct(1, [&](T* dest) { create_object(dest, std::forward<Args>(args)...); });
+        }
+    }
+
+    // Grows to fit count more elements and builds them at dest with construct(dest) before the old
+    // buffer is released, so the source of the new elements may alias the current ones.
+    template <typename Construct>
+    constexpr void grow_construct(size_t count, Construct&& construct) {
+        size_t newCap = grow_capacity(size_ + count);
+        if constexpr (allocator_can_expand<Alloc, T>) {
+            if (data_ && !is_inline() && alloc_.try_expand(data_, capacity_, newCap)) {
+                capacity_ = newCap;
+                Stats::allocated(newCap);
+                construct(data_ + size_);
+                size_ += count;
+                return;
+            }
+        }
+
+        T* newData = AllocTraits::allocate(alloc_, newCap);
+        Stats::allocated(newCap);
+        try {
+            construct(newData + size_);
+        }
+        catch (...) {
+            AllocTraits::deallocate(alloc_, newData, newCap);
+            Stats::deallocated();
+            throw;
+        }
+        try {
+            relocate(data_, size_, newData);
+        }
+        catch (...) {
+            std::destroy_n(newData + size_, count);
+            AllocTraits::deallocate(alloc_, newData, newCap);
+            Stats::deallocated();
+            throw;
+        }
+        if (data_ && !is_inline()) {
+            AllocTraits::deallocate(alloc_, data_, capacity_);
+            Stats::deallocated();
+        }
         data_ = newData;
-        size_ = oldSize;
         capacity_ = newCap;
+        size_ += count;
+    }
+
+    // True when range is a contiguous view of the current elements.
+    template <typename R>
+    constexpr bool aliases_storage(R& range) const {
+        if constexpr (std::ranges::contiguous_range<R>
+            && std::is_same_v<std::remove_cv_t<std::ranges::range_value_t<R>>, T>) {
+            return !std::ranges::empty(range)
+                && vector_detail::points_into(std::to_address(std::ranges::begin(range)), data_, data_ + size_);
+        }
+        else {
+            return false;
+        }
+    }
+
+    constexpr void insert_at(size_t index, const T& element) {
+        if (size_ == capacity_) {
+            if (vector_detail::points_into(std::addressof(element), data_, data_ + size_)) {
+                T copy = std::make_obj_using_allocator<T>(alloc_, element);
+                grow(size_ + 1);
+                insert_at(index, copy);
+                return;
+            }
+            grow(size_ + 1);
+        }
+        vector_detail::insert_one(data_, size_, index, element, constructor());
+        ++size_;
+    }
+
+    constexpr void erase_range(size_t first, size_t last) {
+        vector_detail::erase_range(data_, size_, first, last);
+        size_ -= last - first;
+    }
+
+    // Copy-constructs count elements from first into uninitialized dest, with a memcpy fast path.
+    template <typename It>
+    constexpr void copy_construct_n(It first, size_t count, T* dest) {
+        Stats::copied(count);
+        if (!std::is_constant_evaluated()) {
+            if constexpr (std::contiguous_iterator<It> && std::is_trivially_copyable_v<T>
+                && std::is_same_v<std::iter_value_t<It>, T>) {
+                if (count > 0) {
+                    std::memcpy(static_cast<void*>(dest), static_cast<const void*>(std::to_address(first)), count * sizeof(T));
+                }
+                return;
+            }
+            else if constexpr (plain_construct) {
+                std::uninitialized_copy_n(first, count, dest);
+                return;
+            }
+        }
+        construct_each(dest, count, [&](T* where, size_t) {
+            create_object(where, *first);
+            ++first;
+        });
+    }
+
+    constexpr void fill_construct_n(T* dest, size_t count, const T& value) {
+        Stats::copied(count);
+        if (plain_construct && !std::is_constant_evaluated()) {
+            std::uninitialized_fill_n(dest, count, value);
+        }
+        else {
+            construct_each(dest, count, [&](T* where, size_t) { create_object(where, value); });
+        }
+    }
+
+    constexpr void value_construct_n(T* dest, size_t count) {
+        if (plain_construct && !std::is_constant_evaluated()) {
+            std::uninitialized_value_construct_n(dest, count);
+        }
+        else {
+            construct_each(dest, count, [&](T* where, size_t) { create_object(where); });
+        }
+    }
+
+    // Replaces the contents with a copy of [source, source + count), keeping the buffer when it is large
+    // enough: live elements are copy-assigned, the tail is constructed and any surplus destroyed.
+    // source may point into this Vector.
+    constexpr void assign_copy(const T* source, size_t count) {
+        if (count > capacity_) {
+            clearMemory();
+            allocate_storage(count);
+            copy_construct_n(source, count, data_);
+            size_ = count;
+            return;
+        }
+
+        if (std::is_trivially_copyable_v<T> && !std::is_constant_evaluated()) {
+            Stats::copied(count);
+            if (count > 0) {
+                std::memmove(static_cast<void*>(data_), static_cast<const void*>(source), count * sizeof(T));
+            }
+        }
+        else if (count > size_) {
+            Stats::copied(size_);
+            std::copy_n(source, size_, data_);
+            copy_construct_n(source + size_, count - size_, data_ + size_);
+        }
+        else {
+            Stats::copied(count);
+            std::copy_n(source, count, data_);
+            std::destroy_n(data_ + count, size_ - count);
+        }
+        size_ = count;
     }
 
     template<typename... Args>
-    T* create_object(T* where, Args&&... args) {
+    constexpr T* create_object(T* where, Args&&... args) {
         AllocTraits::construct(alloc_, where, std::forward<Args>(args)...);
         return where;
     }
 
-    void check_size(size_t new_size) const {
+    // create_object and allocator destroy as callables for the algorithms in vector_detail.
+    constexpr auto constructor() noexcept {
+        return [this](T* where, auto&&... args) { create_object(where, std::forward<decltype(args)>(args)...); };
+    }
+
+    constexpr auto destroyer() noexcept {
+        return [this](T* where) { AllocTraits::destroy(alloc_, where); };
+    }
+
+    constexpr void check_size(size_t new_size) const {
         if (new_size > AllocTraits::max_size(alloc_)) {
-            throw length_error("Vector size would exceed maximum allocation size");
+            throw std::length_error("Vector size would exceed maximum allocation size");
         }
     }
 
@@ -81,588 +692,859 @@ public:
     using pointer = T*;
     using const_pointer = const T*;
 
-    Vector() noexcept(noexcept(Alloc()))
-        : capacity_(10)
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    static constexpr size_t alignment = allocator_alignment<Alloc, T>;
+
+    constexpr Vector() noexcept(noexcept(Alloc()))
+        : capacity_(InlineCapacity)
         , size_(0)
-        , data_(AllocTraits::allocate(alloc_, capacity_, data_))
+        , data_(nullptr)
         , alloc_(Alloc()) {
+        data_ = inline_.data();
     }
 
-    explicit Vector(const Alloc& allocator) noexcept
-        : capacity_(10)
+    constexpr explicit Vector(const Alloc& allocator) noexcept
+        : capacity_(InlineCapacity)
         , size_(0)
-        , data_(AllocTraits::allocate(allocator, capacity_, data_))
+        , data_(nullptr)
         , alloc_(allocator) {
+        data_ = inline_.data();
     }
 
-    Vector(size_t count, const T& value, const Alloc& allocator = Alloc())
-        : capacity_(count)
+    constexpr Vector(size_t count, const T& value, const Alloc& allocator = Alloc())
+        : capacity_(0)
         , size_(0)
         , data_(nullptr)
         , alloc_(allocator) {
-        check_size(count);
-        Alloc& nonConstAlloc = const_cast<Alloc&>(alloc_);
-        data_ = AllocTraits::allocate(nonConstAlloc, count);
+        allocate_storage(count);
         try {
-            std::uninitialized_fill_n(data_, count, value);
+            fill_construct_n(data_, count, value);
             size_ = count;
         }
         catch (...) {
-            AllocTraits::deallocate(nonConstAlloc, data_, count);
+            deallocate_storage();
             throw;
         }
     }
 
 
-    explicit Vector(size_t count, const Alloc& allocator = Alloc())
-        : capacity_(count)
+    constexpr explicit Vector(size_t count, const Alloc& allocator = Alloc())
+        : capacity_(0)
         , size_(0)
         , data_(nullptr)
         , alloc_(allocator) {
-        check_size(count);
-        Alloc& nonConstAlloc = const_cast<Alloc&>(alloc_);
-        data_ = AllocTraits::allocate(nonConstAlloc, capacity_);
+        allocate_storage(count);
         try {
-            std::uninitialized_fill_n(data_, count, T());
+            value_construct_n(data_, count);
             size_ = count;
         }
         catch (...) {
-            AllocTraits::deallocate(nonConstAlloc, data_, count);
+            deallocate_storage();
             throw;
         }
     }
 
-    Vector(const Vector& other)
-        : capacity_(other.capacity_)
+    constexpr Vector(const Vector& other)
+        : Vector(other, AllocTraits::select_on_container_copy_construction(other.alloc_)) {
+    }
+
+    constexpr Vector(const Vector& other, const Alloc& allocator)
+        : capacity_(0)
         , size_(0)
         , data_(nullptr)
-        , alloc_(AllocTraits::select_on_container_copy_construction(other.alloc_)) {
-        data_ = AllocTraits::allocate(alloc_, other.size_);
+        , alloc_(allocator) {
+        allocate_storage(other.size_);
         try {
-            std::uninitialized_copy_n(other.data_, other.size_, data_);
+            copy_construct_n(other.data_, other.size_, data_);
             size_ = other.size_;
         }
         catch (...) {
-            AllocTraits::deallocate(alloc_, data_, other.size_);
+            deallocate_storage();
             throw;
         }
     }
 
-    Vector& operator=(const Vector& other) {
+    constexpr Vector& operator=(const Vector& other) {
         if (this != &other) {
-            AllocTraits::deallocate(alloc_, data_, size_);
-
-            size_ = other.size_;
-            capacity_ = other.capacity_;
-            data_ = AllocTraits::allocate(alloc_, capacity_);
-
-            std::uninitialized_copy(other.data_, other.data_ + other.size_, data_);
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (!(alloc_ == other.alloc_)) {
+                    // the current buffer can only be released by the allocator being replaced
+                    clearMemory();
+                }
+                alloc_ = other.alloc_;
+            }
+            assign_copy(other.data_, other.size_);
         }
         return *this;
     }
 
-    Vector(Vector&& other) noexcept
-        : capacity_(std::exchange(other.capacity_, 0))
-        , size_(std::exchange(other.size_, 0))
-        , data_(std::exchange(other.data_, nullptr))
+    // Inline elements cannot be stolen, so moving a SmallVector that has not spilled moves them one by one.
+    constexpr Vector(Vector&& other) noexcept(InlineCapacity == 0 || std::is_nothrow_move_constructible_v<T>)
+        : capacity_(other.capacity_)
+        , size_(other.size_)
+        , data_(other.data_)
         , alloc_(std::move(other.alloc_)) {
+        if (other.is_inline()) {
+            data_ = inline_.data();
+            relocate(other.data_, other.size_, data_);
+        }
+        other.size_ = 0;
+        other.data_ = other.inline_.data();
+        other.capacity_ = InlineCapacity;
     }
 
-    Vector& operator=(Vector&& other) noexcept {
+    // Allocator-extended move: steals the buffer when allocator can free it, moves the elements otherwise.
+    constexpr Vector(Vector&& other, const Alloc& allocator)
+        : capacity_(0)
+        , size_(0)
+        , data_(nullptr)
+        , alloc_(allocator) {
+        if (!other.is_inline() && (AllocTraits::is_always_equal::value || alloc_ == other.alloc_)) {
+            capacity_ = std::exchange(other.capacity_, InlineCapacity);
+            size_ = std::exchange(other.size_, 0);
+            data_ = std::exchange(other.data_, other.inline_.data());
+            return;
+        }
+        allocate_storage(other.size_);
+        try {
+            relocate(other.data_, other.size_, data_);
+        }
+        catch (...) {
+            deallocate_storage();
+            throw;
+        }
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    constexpr Vector& operator=(Vector&& other) noexcept((InlineCapacity == 0 || std::is_nothrow_move_constructible_v<T>)
+        && (AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value)) {
         if (this != &other) {
             clearMemory();
-            capacity_ = std::exchange(other.capacity_, 0);
-            size_ = std::exchange(other.size_, 0);
-            data_ = std::exchange(other.data_, nullptr);
-            if (AllocTraits::propagate_on_container_move_assignment::value) {
+            if constexpr (!AllocTraits::propagate_on_container_move_assignment::value && !AllocTraits::is_always_equal::value) {
+                if (!(alloc_ == other.alloc_)) {
+                    // other's buffer belongs to an allocator we keep apart from, so only the elements move over
+                    allocate_storage(other.size_);
+                    relocate(other.data_, other.size_, data_);
+                    size_ = std::exchange(other.size_, 0);
+                    return *this;
+                }
+            }
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
                 alloc_ = std::move(other.alloc_);
             }
+            if (other.is_inline()) {
+                relocate(other.data_, other.size_, data_);
+                size_ = std::exchange(other.size_, 0);
+            }
+            else {
+                capacity_ = std::exchange(other.capacity_, InlineCapacity);
+                size_ = std::exchange(other.size_, 0);
+                data_ = std::exchange(other.data_, other.inline_.data());
+            }
         }
         return *this;
     }
 
-    Vector(std::initializer_list<T> init, const Alloc& allocator = Alloc())
-        : capacity_(init.size())
+    constexpr Vector(std::initializer_list<T> init, const Alloc& allocator = Alloc())
+        : capacity_(0)
         , size_(0)
         , data_(nullptr)
         , alloc_(allocator) {
-        data_ = AllocTraits::allocate(alloc_, init.size());
+        allocate_storage(init.size());
         try {
-            std::uninitialized_copy(init.begin(), init.end(), data_);
+            copy_construct_n(init.begin(), init.size(), data_);
             size_ = init.size();
         }
         catch (...) {
-            AllocTraits::deallocate(alloc_, data_, init.size());
+            deallocate_storage();
             throw;
         }
     }
 
-    void swap(Vector& other) noexcept {
-        //using std::swap;
+    constexpr void swap(Vector& other) noexcept(InlineCapacity == 0 || std::is_nothrow_move_constructible_v<T>) {
+        if (is_inline() || other.is_inline()) {
+            Vector tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+            return;
+        }
+
         std::swap(size_, other.size_);
         std::swap(capacity_, other.capacity_);
         std::swap(data_, other.data_);
-        if (AllocTraits::propagate_on_container_swap::value) {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
             swap(alloc_, other.alloc_);
         }
     }
 
-    [[nodiscard]] allocator<T> get_allocator() const noexcept {
+    [[nodiscard]] constexpr Alloc get_allocator() const noexcept {
         return alloc_;
     }
 
     template <bool isConst>
     class baseIterator {
     public:
+        using iterator_concept = std::contiguous_iterator_tag;
         using iterator_category = std::random_access_iterator_tag;
         using value_type = T;
+        using element_type = std::conditional_t<isConst, const T, T>;
         using difference_type = std::ptrdiff_t;
         using pointer = std::conditional_t<isConst, const T*, T*>;
         using reference = std::conditional_t<isConst, const T&, T&>;
 
     private:
+        template <bool>
+        friend class baseIterator;
+
         T* ptr;
 
     public:
 
         template <bool OtherIsConst, typename = std::enable_if_t<isConst && !OtherIsConst>>
-        baseIterator(const baseIterator<OtherIsConst>& other) noexcept : ptr(other.ptr) {}
-        baseIterator(T* p = nullptr) noexcept : ptr(p) {}
+        constexpr baseIterator(const baseIterator<OtherIsConst>& other) noexcept : ptr(other.ptr) {}
+        constexpr baseIterator(T* p = nullptr) noexcept : ptr(p) {}
         baseIterator(const baseIterator& other) noexcept = default;
         baseIterator& operator=(const baseIterator& other) noexcept = default;
 
-        reference operator*() const noexcept { return *ptr; }
-        pointer operator->() const noexcept { return ptr; }
-        reference operator[](difference_type n) const noexcept { return ptr[n]; }
+        constexpr reference operator*() const noexcept { return *ptr; }
+        constexpr pointer operator->() const noexcept { return ptr; }
+        constexpr reference operator[](difference_type n) const noexcept { return ptr[n]; }
 
-        baseIterator& operator++() noexcept {
+        constexpr baseIterator& operator++() noexcept {
             ++ptr;
             return *this;
         }
 
-        baseIterator operator++(int) noexcept {
+        constexpr baseIterator operator++(int) noexcept {
             baseIterator tmp(*this);
             ++ptr;
             return tmp;
         }
 
-        baseIterator& operator--() noexcept {
+        constexpr baseIterator& operator--() noexcept {
             --ptr;
             return *this;
         }
 
-        baseIterator operator--(int) noexcept {
+        constexpr baseIterator operator--(int) noexcept {
             baseIterator tmp(*this);
             --ptr;
             return tmp;
         }
 
-        baseIterator& operator+=(difference_type n) noexcept {
+        constexpr baseIterator& operator+=(difference_type n) noexcept {
             ptr += n;
             return *this;
         }
 
-        baseIterator operator+(difference_type n) const noexcept {
+        constexpr baseIterator operator+(difference_type n) const noexcept {
             baseIterator tmp(*this);
             tmp += n;
             return tmp;
         }
 
-        baseIterator& operator-=(difference_type n) noexcept {
+        constexpr baseIterator& operator-=(difference_type n) noexcept {
             ptr -= n;
             return *this;
         }
 
-        baseIterator operator-(difference_type n) const noexcept {
+        constexpr baseIterator operator-(difference_type n) const noexcept {
             baseIterator tmp(*this);
             tmp -= n;
             return tmp;
         }
 
-        difference_type operator-(const baseIterator& other) const noexcept {
+        constexpr difference_type operator-(const baseIterator& other) const noexcept {
             return ptr - other.ptr;
         }
 
-        bool operator==(const baseIterator& other) const noexcept {
+        constexpr bool operator==(const baseIterator& other) const noexcept {
             return ptr == other.ptr;
         }
 
-        bool operator!=(const baseIterator& other) const noexcept {
+        constexpr bool operator!=(const baseIterator& other) const noexcept {
             return !(*this == other);
         }
 
-        bool operator<(const baseIterator& other) const noexcept {
+        constexpr bool operator<(const baseIterator& other) const noexcept {
             return ptr < other.ptr;
         }
 
-        bool operator>(const baseIterator& other) const noexcept {
+        constexpr bool operator>(const baseIterator& other) const noexcept {
             return other < *this;
         }
 
-        bool operator<=(const baseIterator& other) const noexcept {
+        constexpr bool operator<=(const baseIterator& other) const noexcept {
             return !(other < *this);
         }
 
-        bool operator>=(const baseIterator& other) const noexcept {
+        constexpr bool operator>=(const baseIterator& other) const noexcept {
             return !(*this < other);
         }
     };
 
-    friend baseIterator<false> operator+(typename baseIterator<false>::difference_type n,
+    friend constexpr baseIterator<false> operator+(typename baseIterator<false>::difference_type n,
         const baseIterator<false>& it) noexcept {
         return it + n;
     }
 
-    friend baseIterator<true> operator+(typename baseIterator<true>::difference_type n,
+    friend constexpr baseIterator<true> operator+(typename baseIterator<true>::difference_type n,
         const baseIterator<true>& it) noexcept {
         return it + n;
     }
 
-    template <bool isConst>
-    class reverseIterator {
-    public:
-        using iterator_category = std::random_access_iterator_tag;
-        using value_type = T;
-        using difference_type = std::ptrdiff_t;
-        using pointer = std::conditional_t<isConst, const T*, T*>;
-        using reference = std::conditional_t<isConst, const T&, T&>;
+    using Iterator = baseIterator<false>;
+    using ConstIterator = baseIterator<true>;
+    using RIterator = std::reverse_iterator<Iterator>;
+    using ConstRIterator = std::reverse_iterator<ConstIterator>;
 
-    private:
-        T* ptr;
+    constexpr Iterator begin() noexcept { return Iterator(data_); }
+    constexpr Iterator end() noexcept { return Iterator(data_ + size_); }
 
-    public:
-        reverseIterator(T* p = nullptr) noexcept : ptr(p) {}
-        reverseIterator(const reverseIterator& other) noexcept = default;
-        reverseIterator& operator=(const reverseIterator& other) noexcept = default;
+    constexpr ConstIterator begin() const noexcept { return ConstIterator(data_); }
+    constexpr ConstIterator end() const noexcept { return ConstIterator(data_ + size_); }
 
-        reference operator*() const noexcept { return *ptr; }
-        pointer operator->() const noexcept { return ptr; }
-        reference operator[](difference_type n) const noexcept { return ptr[-n]; }
+    constexpr ConstIterator cbegin() const noexcept { return begin(); }
+    constexpr ConstIterator cend() const noexcept { return end(); }
 
-        reverseIterator& operator++() noexcept {
-            --ptr;
-            return *this;
-        }
+    // Built over end()/begin() so that no pointer before the storage is ever formed.
+    constexpr RIterator rbegin() noexcept { return RIterator(end()); }
+    constexpr RIterator rend() noexcept { return RIterator(begin()); }
 
-        reverseIterator operator++(int) noexcept {
-            reverseIterator tmp(*this);
-            --ptr;
-            return tmp;
-        }
+    constexpr ConstRIterator rbegin() const noexcept { return ConstRIterator(end()); }
+    constexpr ConstRIterator rend() const noexcept { return ConstRIterator(begin()); }
 
-        reverseIterator& operator--() noexcept {
-            ++ptr;
-            return *this;
-        }
+    constexpr ConstRIterator crbegin() const noexcept { return rbegin(); }
+    constexpr ConstRIterator crend() const noexcept { return rend(); }
 
-        reverseIterator operator--(int) noexcept {
-            reverseIterator tmp(*this);
-            ++ptr;
-            return tmp;
+    constexpr void reserve(size_t newCapacity) {
+        if (newCapacity > capacity_) {
+            check_size(newCapacity);
+            reallocate_storage(newCapacity);
         }
+    }
 
-        reverseIterator& operator+=(difference_type n) noexcept {
-            ptr -= n;
-            return *this;
+    template <typename... Args>
+    constexpr void emplace_back(Args&&... args) {
+        if (size_ == capacity_) {
+            emplace_back_grow(std::forward<Args>(args)...);
+            return;
         }
-
-        reverseIterator operator+(difference_type n) const noexcept {
-            reverseIterator tmp(*this);
-            tmp += n;
-            return tmp;
+        if constexpr (std::is_trivially_constructible_v<T, Args...>) {
+            std::construct_at(data_ + size_, std::forward<Args>(args)...);
         }
-
-        reverseIterator& operator-=(difference_type n) noexcept {
-            ptr += n;
-            return *this;
+        else {
+            create_object(data_ + size_, std::forward<Args>(args)...);
         }
+        ++size_;
+    }
 
-        reverseIterator operator-(difference_type n) const noexcept {
-            reverseIterator tmp(*this);
-            tmp -= n;
-            return tmp;
-        }
+    constexpr void push_back(const T& value) {
+        emplace_back(value);
+    }
 
-        difference_type operator-(const reverseIterator& other) const noexcept {
-            return other.ptr - ptr;
-        }
+    constexpr void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
 
-        bool operator==(const reverseIterator& other) const noexcept {
-            return ptr == other.ptr;
-        }
+    constexpr void push_back(std::initializer_list<T>&& init) {
+        append_range(init);
+    }
 
-        bool operator!=(const reverseIterator& other) const noexcept {
-            return !(*this == other);
+    template <std::ranges::input_range R>
+    constexpr void append_range(R&& range) {
+        if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>) {
+            size_t count = static_cast<size_t>(std::ranges::distance(range));
+            if (size_ + count > capacity_) {
+                if constexpr (allocator_can_reallocate<Alloc, T> && is_trivially_relocatable_v<T>
+                    && std::ranges::contiguous_range<R>) {
+                    // reallocate() keeps the move-free path when the range lives elsewhere
+                    if (!aliases_storage(range)) {
+                        grow(size_ + count);
+                        copy_construct_n(std::ranges::begin(range), count, data_ + size_);
+                        size_ += count;
+                        return;
+                    }
+                }
+                grow_construct(count, [&](T* dest) { copy_construct_n(std::ranges::begin(range), count, dest); });
+                return;
+            }
+            copy_construct_n(std::ranges::begin(range), count, data_ + size_);
+            size_ += count;
         }
-
-        bool operator<(const reverseIterator& other) const noexcept {
-            return ptr > other.ptr;
+        else {
+            for (auto&& element : range) {
+                emplace_back(std::forward<decltype(element)>(element));
+            }
         }
+    }
 
-        bool operator>(const reverseIterator& other) const noexcept {
-            return other < *this;
+    template <std::ranges::input_range R>
+    constexpr void insert_range(size_t index, R&& range) {
+        if (index > size_) {
+            vector_check::throw_out_of_range(static_cast<size_t>(index), size_);
         }
 
-        bool operator<=(const reverseIterator& other) const noexcept {
-            return !(other < *this);
-        }
+        if constexpr ((std::ranges::forward_range<R> || std::ranges::sized_range<R>) && is_trivially_relocatable_v<T>) {
+            if (!std::is_constant_evaluated()) {
+                size_t count = static_cast<size_t>(std::ranges::distance(range));
+                if (count == 0) {
+                    return;
+                }
 
-        bool operator>=(const reverseIterator& other) const noexcept {
-            return !(*this < other);
+                if (size_ + count > capacity_) {
+                    size_t newCap = grow_capacity(size_ + count);
+                    T* newData = AllocTraits::allocate(alloc_, newCap);
+                    Stats::allocated(newCap);
+                    try {
+                        copy_construct_n(std::ranges::begin(range), count, newData + index);
+                    }
+                    catch (...) {
+                        AllocTraits::deallocate(alloc_, newData, newCap);
+                        Stats::deallocated();
+                        throw;
+                    }
+                    relocate(data_, index, newData);
+                    relocate(data_ + index, size_ - index, newData + index + count);
+                    if (data_ && !is_inline()) {
+                        AllocTraits::deallocate(alloc_, data_, capacity_);
+                        Stats::deallocated();
+                    }
+                    data_ = newData;
+                    capacity_ = newCap;
+                }
+                else if (aliases_storage(range)) {
+                    // shifting the tail first would overwrite the source
+                    size_t oldSize = size_;
+                    append_range(range);
+                    std::rotate(data_ + index, data_ + oldSize, data_ + size_);
+                    return;
+                }
+                else {
+                    T* gap = data_ + index;
+                    size_t tail = (size_ - index) * sizeof(T);
+                    std::memmove(static_cast<void*>(gap + count), static_cast<const void*>(gap), tail);
+                    try {
+                        copy_construct_n(std::ranges::begin(range), count, gap);
+                    }
+                    catch (...) {
+                        std::memmove(static_cast<void*>(gap), static_cast<const void*>(gap + count), tail);
+                        throw;
+                    }
+                }
+                size_ += count;
+                return;
+            }
         }
-    };
 
-    friend reverseIterator<false> operator+(typename reverseIterator<false>::difference_type n,
-        const reverseIterator<false>& it) noexcept {
-        return it + n;
+        size_t oldSize = size_;
+        append_range(std::forward<R>(range));
+        std::rotate(data_ + index, data_ + oldSize, data_ + size_);
     }
 
-    friend reverseIterator<true> operator+(typename reverseIterator<true>::difference_type n,
-        const reverseIterator<true>& it) noexcept {
-        return it + n;
+    template <std::ranges::input_range R>
+    constexpr void insert_range(Iterator pos, R&& range) {
+        insert_range(static_cast<size_t>(pos - begin()), std::forward<R>(range));
     }
 
-    using Iterator = baseIterator<false>;
-    using ConstIterator = baseIterator<true>;
-    using RIterator = reverseIterator<false>;
-    using ConstRIterator = reverseIterator<true>;
-
-    Iterator begin() noexcept { return Iterator(data_); }
-    Iterator end() noexcept { return Iterator(data_ + size_); }
-
-    ConstIterator begin() const noexcept { return ConstIterator(data_); }
-    ConstIterator end() const noexcept { return ConstIterator(data_ + size_); }
-
-    ConstIterator cbegin() const noexcept { return ConstIterator(data_); }
-    ConstIterator cend() const noexcept { return ConstIterator(data_ + size_); }
+    template <std::input_iterator It>
+    constexpr void assign(It first, It last) {
+        clear();
+        append_range(std::ranges::subrange(first, last));
+    }
 
-    RIterator rbegin() noexcept { return RIterator(data_ + size_ - 1); }
-    RIterator rend() noexcept { return RIterator(data_ - 1); }
+    constexpr void assign(size_t count, const T& value) {
+        T copy = std::make_obj_using_allocator<T>(alloc_, value);
+        clear();
+        resize(count, copy);
+    }
 
-    ConstRIterator rbegin() const noexcept { return ConstRIterator(data_ + size_ - 1); }
-    ConstRIterator rend() const noexcept { return ConstRIterator(data_ - 1); }
+    constexpr void assign(std::initializer_list<T> init) {
+        assign_copy(init.begin(), init.size());
+    }
 
-    ConstRIterator crbegin() const noexcept { return ConstRIterator(data_ + size_ - 1); }
-    ConstRIterator crend() const noexcept { return ConstRIterator(data_ - 1); }
+    // Copy-assigns from any contiguous source, reusing the current buffer when it is large enough.
+    constexpr void copy_from(std::span<const T> source) {
+        assign_copy(source.data(), source.size());
+    }
 
-    void reserve(size_t newCapacity) {
-        if (newCapacity > capacity_) {
-            resize(newCapacity);
+    constexpr void resize(size_t count) {
+        if (count < size_) {
+            std::destroy_n(data_ + count, size_ - count);
+            size_ = count;
+            return;
+        }
+        if (count > capacity_) {
+            grow(count);
         }
+        value_construct_n(data_ + size_, count - size_);
+        size_ = count;
     }
 
-    template <typename... Args>
-    void emplace_back(Args&&... args) {
-        if (size_ == capacity_) {
-            size_t newCap = capacity_ == 0 ? 1 : capacity_ + (capacity_ >> 1) + 1;
-            resize(newCap);
+    constexpr void resize(size_t count, const T& value) {
+        if (count < size_) {
+            std::destroy_n(data_ + count, size_ - count);
+            size_ = count;
+            return;
         }
-        if constexpr (std::is_trivially_constructible_v<T, Args...>) {
-            new (data_ + size_) T(std::forward<Args>(args)...);
+        if (count > capacity_) {
+            // value may refer into the buffer that grow() releases
+            T copy = std::make_obj_using_allocator<T>(alloc_, value);
+            grow(count);
+            fill_construct_n(data_ + size_, count - size_, copy);
         }
         else {
-            create_object(data_ + size_, std::forward<Args>(args)...);
+            fill_construct_n(data_ + size_, count - size_, value);
         }
-        ++size_;
-    }
-
-    void push_back(const T& value) {
-        emplace_back(value);
-    }
-
-    void push_back(T&& value) {
-        emplace_back(std::move(value));
+        size_ = count;
     }
 
-    void push_back(initializer_list<T>&& init) {
-        for (const auto&& i : init) {
-            emplace_back(forward<decltype(i)>(i));
+    // Like resize(count), but new elements are default-initialized: trivial types are left
+    // uninitialized for the caller to overwrite. This holds for pmr::Vector too; other allocators with
+    // a construct member are asked to construct(p) each new element, which usually value-initializes.
+    constexpr void resize_for_overwrite(size_t count) {
+        if (count < size_) {
+            for (T* p = data_ + count; p != data_ + size_; ++p) {
+                AllocTraits::destroy(alloc_, p);
+            }
+            size_ = count;
+            return;
+        }
+        if (count > capacity_) {
+            grow(count);
+        }
+        if (plain_default_construct && !std::is_constant_evaluated()) {
+            std::uninitialized_default_construct_n(data_ + size_, count - size_);
+        }
+        else {
+            value_construct_n(data_ + size_, count - size_);
         }
+        size_ = count;
     }
 
-    void pop_back() {
-        if (empty()) {
-            throw std::out_of_range("Vector is empty");
-        }
+    // Reserves room for count more elements and lets write(dest, count) fill a prefix of it directly,
+    // e.g. from read()/recv(). Returns the number of elements write reports, which become part of the Vector.
+    template <typename Fn>
+        requires std::is_invocable_r_v<size_t, Fn&, T*, size_t>
+    constexpr size_t append_uninitialized(size_t count, Fn&& write) {
+        static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+            "append_uninitialized requires a trivial element type");
 
-        if constexpr (std::is_trivially_destructible_v<T>) {
-            (data_ + size_ - 1)->~T();
-            --size_;
-            return;
+        if (size_ + count > capacity_) {
+            grow(size_ + count);
+        }
+        size_t written = std::invoke(write, data_ + size_, count);
+        if (written > count) {
+            throw std::length_error("append_uninitialized callback reported more elements than requested");
         }
+        size_ += written;
+        return written;
+    }
 
-        AllocTraits::destroy(alloc_, data_ + size_);
+    constexpr void pop_back() {
+        VECTOR_CHECK(size_ > 0, "pop_back() on an empty Vector", 0, size_);
         --size_;
+        AllocTraits::destroy(alloc_, data_ + size_);
     }
 
-    reference operator[](int index) {
-        return *(data_ + index);
+    constexpr reference operator[](size_t index) noexcept {
+        VECTOR_CHECK(index < size_, "operator[] index out of range", index, size_);
+        return data_[index];
     }
 
-    const_reference operator[](int index) const {
-        return *(data_ + index);
+    constexpr const_reference operator[](size_t index) const noexcept {
+        VECTOR_CHECK(index < size_, "operator[] index out of range", index, size_);
+        return data_[index];
     }
 
-    reference back() {
-        if (size_ <= 0) {
-            throw out_of_range("Vector is empty");
-        }
+    constexpr reference back() noexcept {
+        VECTOR_CHECK(size_ > 0, "back() on an empty Vector", 0, size_);
         return data_[size_ - 1];
     }
 
-    const_reference back() const {
-        if (size_ <= 0) {
-            throw out_of_range("Vector is empty");
-        }
+    constexpr const_reference back() const noexcept {
+        VECTOR_CHECK(size_ > 0, "back() on an empty Vector", 0, size_);
         return data_[size_ - 1];
     }
 
-    bool find(const T& element) const {
-        return std::find(data_, data_ + size_, element) != data_ + size_;
+    constexpr bool find(const T& element) const {
+        return index(element) != npos;
     }
 
-    size_t index(const T& element) const {
-        auto it = std::find(data_, data_ + size_, element);
-        return it != data_ + size_ ? static_cast<int>(it - data_) : -1;
+    constexpr bool contains(const T& element) const {
+        return index(element) != npos;
     }
 
-    void insert(const T& element, size_t index) {
-        if (index > size_ || index < 0) {
-            throw out_of_range(format("Index {} out of range (size: {})", index, size_));
-        }
-
-        if (size_ == capacity_) {
-            size_t newCapacity = capacity_ == 0 ? 1 : capacity_ + (capacity_ >> 1);
-            reserve(newCapacity);
-        }
-
-        if (index < size_) {
-            std::move_backward(data_ + index, data_ + size_, data_ + size_ + 1);
-        }
+    // Position of the first occurrence of element, or npos.
+    constexpr size_t index(const T& element) const {
+        return vector_detail::index(data_, size_, element);
+    }
 
-        create_object(data_ + index, element);
-        ++size_;
+    // Position of the last occurrence of element, or npos.
+    constexpr size_t rfind(const T& element) const {
+        return vector_detail::rfind(data_, size_, element);
     }
 
-    void insert(const T& element, Iterator pos) {
-        auto index = distance(begin(), pos);
+    constexpr size_t count(const T& element) const {
+        return vector_detail::count(data_, size_, element);
+    }
 
-        if (index > size_ || index < 0) {
-            throw out_of_range(format("Index {} out of range (size: {})", index, size_));
+    constexpr void insert(const T& element, size_t index) {
+        if (index > size_) {
+            vector_check::throw_out_of_range(static_cast<size_t>(index), size_);
         }
+        insert_at(index, element);
+    }
 
-        if (size_ == capacity_) {
-            if (size_ == capacity_) {
-                size_t newCapacity = capacity_ == 0 ? 1 : capacity_ + (capacity_ >> 1);
-                reserve(newCapacity);
-            }
-        }
+    constexpr void insert(const T& element, Iterator pos) {
+        auto index = std::distance(begin(), pos);
 
-        if (index < size_) {
-            std::move_backward(data_ + index, data_ + size_, data_ + size_ + 1);
+        if (index < 0 || static_cast<size_t>(index) > size_) {
+            vector_check::throw_out_of_range(static_cast<size_t>(index), size_);
         }
-
-        create_object(data_ + index, element);
-        ++size_;
+        insert_at(static_cast<size_t>(index), element);
     }
 
-    void erase(size_t index) {
+    constexpr void erase(size_t index) {
         if (index >= size_) {
-            throw out_of_range("Index out of range");
+            vector_check::throw_out_of_range("Index out of range");
         }
-        std::move(data_ + index + 1, data_ + size_, data_ + index);
-        AllocTraits::destroy(alloc_, data_ + size_ - 1);
-        --size_;
+        erase_range(index, index + 1);
     }
 
-    template <typename Iterator>
-    Iterator erase(Iterator pos) {
-        return erase(pos, pos + 1);
+    constexpr Iterator erase(Iterator pos) {
+        VECTOR_CHECK(pos >= begin() && pos < end(), "erase() iterator out of range", pos - begin(), size_);
+        size_t index = static_cast<size_t>(pos - begin());
+        erase_range(index, index + 1);
+        return begin() + static_cast<std::ptrdiff_t>(index);
     }
 
-    T erase(size_t first_index, size_t last_index) {
+    constexpr size_t erase(size_t first_index, size_t last_index) {
         if (first_index > last_index || last_index > size_) {
-            throw out_of_range("Invalid index range");
-        }
-
-        if (first_index == last_index) {
-            return;
+            vector_check::throw_out_of_range("Invalid index range");
         }
 
-        auto count = last_index - first_index;
-        std::move(data_ + last_index, data_ + size_, data_ + first_index);
-
-        for (size_t i = 0; i < count; ++i) {
-            AllocTraits::destroy(alloc_, data_ + size_ - 1 - i);
-        }
-        size_ -= count;
+        erase_range(first_index, last_index);
 
         return first_index;
     }
 
-    Iterator erase(Iterator first, Iterator last) {
-        if (first < begin() || last < begin() || first > end() || last > end() || first > last) {
-            throw std::out_of_range("Iterator out of range");
-        }
+    constexpr Iterator erase(Iterator first, Iterator last) {
+        VECTOR_CHECK(first >= begin() && first <= last && last <= end(), "erase() iterator range out of bounds",
+            first - begin(), size_);
+
+        size_t index = static_cast<size_t>(first - begin());
+        erase_range(index, static_cast<size_t>(last - begin()));
 
-        auto new_end = std::move(last, end(), first);
+        return begin() + static_cast<std::ptrdiff_t>(index);
+    }
 
-        for (auto it = new_end; it != end(); ++it) {
-            AllocTraits::destroy(alloc_, std::addressof(*it));
+    // O(1) erase that does not preserve order: the last element takes the place of the erased one.
+    constexpr void unordered_erase(size_t index) {
+        if (index >= size_) {
+            vector_check::throw_out_of_range("Index out of range");
         }
+        vector_detail::unordered_erase(data_, size_, index, destroyer());
+        --size_;
+    }
 
-        size_ -= std::distance(first, last);
+    // Removes every element matching pred in a single pass and returns how many were removed.
+    template <typename Pred>
+    constexpr size_t erase_if(Pred pred) {
+        return vector_detail::erase_if(data_, size_, pred, destroyer());
+    }
 
-        return first;
+    // Removes the elements at the given strictly increasing indices, compacting the rest in one sweep.
+    constexpr void erase_indices(std::span<const size_t> indices) {
+        vector_detail::erase_indices(data_, size_, indices, destroyer());
     }
 
-    [[nodiscard]] bool empty() const noexcept {
+    [[nodiscard]] constexpr bool empty() const noexcept {
         return size_ == 0;
     }
 
-    void clear() {
-        destroy_n(data_, size_);
+    constexpr void clear() {
+        std::destroy_n(data_, size_);
         size_ = 0;
     }
 
-    [[nodiscard]] size_t size() const noexcept {
+    [[nodiscard]] constexpr size_t size() const noexcept {
         return size_;
     }
 
-    [[nodiscard]] size_t capacity() const noexcept {
+    [[nodiscard]] constexpr size_t capacity() const noexcept {
         return capacity_;
     }
 
-    [[nodiscard]] T& at(size_t index) {
+    [[nodiscard]] constexpr T* data() noexcept {
+        return data_;
+    }
+
+    [[nodiscard]] constexpr const T* data() const noexcept {
+        return data_;
+    }
+
+    // data() with the storage alignment promised to the optimizer, e.g. 64 for AlignedAllocator<T, 64>.
+    template <size_t Align = alignment>
+    [[nodiscard]] constexpr T* aligned_data() noexcept {
+        static_assert(Align <= alignment, "Vector storage is not guaranteed to be that aligned");
+        return std::assume_aligned<Align>(data_);
+    }
+
+    template <size_t Align = alignment>
+    [[nodiscard]] constexpr const T* aligned_data() const noexcept {
+        static_assert(Align <= alignment, "Vector storage is not guaranteed to be that aligned");
+        return std::assume_aligned<Align>(data_);
+    }
+
+    constexpr operator std::span<T>() noexcept {
+        return {data_, size_};
+    }
+
+    constexpr operator std::span<const T>() const noexcept {
+        return {data_, size_};
+    }
+
+    // count elements starting at first, without copying.
+    [[nodiscard]] constexpr VectorView<T> slice(size_t first, size_t count) {
+        return VectorView<T>(data_, size_).slice(first, count);
+    }
+
+    [[nodiscard]] constexpr VectorView<const T> slice(size_t first, size_t count) const {
+        return VectorView<const T>(data_, size_).slice(first, count);
+    }
+
+    // Every stride-th element starting at first.
+    [[nodiscard]] constexpr StridedView<T> strided(size_t first, size_t stride) {
+        return VectorView<T>(data_, size_).strided(first, stride);
+    }
+
+    [[nodiscard]] constexpr StridedView<const T> strided(size_t first, size_t stride) const {
+        return VectorView<const T>(data_, size_).strided(first, stride);
+    }
+
+    // Takes ownership of size constructed elements in a buffer of capacity elements obtained from
+    // allocator.allocate(capacity); the Vector destroys and deallocates them later through allocator.
+    [[nodiscard]] static constexpr Vector adopt(T* data, size_t size, size_t capacity, const Alloc& allocator = Alloc()) {
+        if (size > capacity || (!data && capacity > 0)) {
+            throw std::invalid_argument("adopt() needs size <= capacity and a buffer for a non-zero capacity");
+        }
+        Vector result(allocator);
+        if (data) {
+            result.data_ = data;
+            result.size_ = size;
+            result.capacity_ = capacity;
+        }
+        return result;
+    }
+
+    // Hands the heap buffer and its elements to the caller and leaves the Vector empty. The caller
+    // destroys the elements and frees data with get_allocator().deallocate(data, capacity). Elements
+    // held in the inline buffer of a SmallVector are first relocated to the heap.
+    [[nodiscard]] constexpr VectorBuffer<T> release() {
+        if (is_inline()) {
+            if (size_ == 0) {
+                return {};
+            }
+            T* heap = AllocTraits::allocate(alloc_, size_);
+            Stats::allocated(size_);
+            try {
+                relocate(data_, size_, heap);
+            }
+            catch (...) {
+                AllocTraits::deallocate(alloc_, heap, size_);
+                Stats::deallocated();
+                throw;
+            }
+            VectorBuffer<T> buffer{heap, size_, size_};
+            size_ = 0;
+            return buffer;
+        }
+        VectorBuffer<T> buffer{data_, size_, capacity_};
+        size_ = 0;
+        data_ = inline_.data();
+        capacity_ = InlineCapacity;
+        return buffer;
+    }
+
+    [[nodiscard]] constexpr T& at(size_t index) {
         if (index >= size_) {
-            throw out_of_range(format("Index {} out of range (size: {})", index, size_));
+            vector_check::throw_out_of_range(static_cast<size_t>(index), size_);
         }
         return data_[index];
     }
 
-    [[nodiscard]] const T& at(size_t index) const {
+    [[nodiscard]] constexpr const T& at(size_t index) const {
         if (index >= size_) {
-            throw out_of_range(format("Index {} out of range (size: {})", index, size_));
+            vector_check::throw_out_of_range(static_cast<size_t>(index), size_);
         }
         return data_[index];
     }
 
-    void shrink_to_fit() {
-        if (size_ < capacity_) {
-            if constexpr (std::is_trivially_copyable_v<T>) {
-                if (T* newData = static_cast<T*>(std::realloc(data_, size_ * sizeof(T)))) {
-                    data_ = newData;
-                    capacity_ = size_;
-                    return;
+    constexpr void shrink_to_fit() {
+        if (size_ < capacity_ && !is_inline()) {
+            Stats::retired(capacity_, size_);
+            if (size_ <= InlineCapacity) {
+                T* oldData = data_;
+                size_t oldCapacity = capacity_;
+                if constexpr (InlineCapacity > 0) {
+                    relocate(oldData, size_, inline_.data());
                 }
+                AllocTraits::deallocate(alloc_, oldData, oldCapacity);
+                Stats::deallocated();
+                data_ = inline_.data();
+                capacity_ = InlineCapacity;
+                return;
+            }
+            if (reallocate_in_place(size_)) {
+                return;
             }
             T* newData = AllocTraits::allocate(alloc_, size_);
-            std::uninitialized_move_n(data_, size_, newData);
-            clearMemory();
+            Stats::allocated(size_);
+            try {
+                relocate(data_, size_, newData);
+            }
+            catch (...) {
+                AllocTraits::deallocate(alloc_, newData, size_);
+                Stats::deallocated();
+                throw;
+            }
+            AllocTraits::deallocate(alloc_, data_, capacity_);
+            Stats::deallocated();
             data_ = newData;
             capacity_ = size_;
         }
     }
 
-    ~Vector() { clearMemory(); }
+    constexpr ~Vector() { clearMemory(); }
 };
+
+template <typename T, size_t N, class Alloc = std::allocator<T>, growth_policy GrowthPolicy = DefaultGrowth>
+using SmallVector = Vector<T, Alloc, GrowthPolicy, N>;
+
+// Vector whose allocations, relocations and copies are counted in vector_stats under the label Site.
+template <typename T, vector_stats::site_name Site = "", class Alloc = std::allocator<T>>
+using InstrumentedVector = Vector<T, Alloc, InstrumentedGrowth<DefaultGrowth, Site>>;
+
+// Runs Make at compile time and copies the Vector it returns into a std::array of the same size, so that
+// tables built with push_back end up in static storage:
+//     constexpr auto crc_table = to_static_array<[] { Vector<uint32_t> t; ...; return t; }>();
+template <auto Make>
+consteval auto to_static_array() {
+    using V = decltype(Make());
+    std::array<typename V::value_type, Make().size()> table{};
+    V built = Make();
+    std::copy(built.begin(), built.end(), table.begin());
+    return table;
+}
+
+namespace pmr {
+
+template <typename T, growth_policy GrowthPolicy = DefaultGrowth>
+using Vector = ::Vector<T, std::pmr::polymorphic_allocator<T>, GrowthPolicy>;
+
+template <typename T, size_t N, growth_policy GrowthPolicy = DefaultGrowth>
+using SmallVector = ::Vector<T, std::pmr::polymorphic_allocator<T>, GrowthPolicy, N>;
+
+}
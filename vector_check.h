@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+// Precondition checks for Vector's unchecked accessors: operator[], back(), pop_back() and iterator
+// erase. Select the level before including vector.h:
+//     VECTOR_CHECK_OFF     no checks; operator[] compiles to a single load (default with NDEBUG)
+//     VECTOR_CHECK_ASSERT  report the failed check with index and size on stderr, then abort (default otherwise)
+//     VECTOR_CHECK_TRAP    execute a trap instruction, with no message and the smallest code
+// e.g. -DVECTOR_CHECK_LEVEL=VECTOR_CHECK_TRAP for hardened release builds. Iterators stay plain pointers
+// at every level: they cannot see the live size of their Vector, so they are not checked.
+//
+// The failure paths and the at()/insert() exception messages live in cold, never-inlined functions so
+// the checks stay a compare and a branch in the caller.
+#define VECTOR_CHECK_OFF 0
+#define VECTOR_CHECK_ASSERT 1
+#define VECTOR_CHECK_TRAP 2
+
+#ifndef VECTOR_CHECK_LEVEL
+#ifdef NDEBUG
+#define VECTOR_CHECK_LEVEL VECTOR_CHECK_OFF
+#else
+#define VECTOR_CHECK_LEVEL VECTOR_CHECK_ASSERT
+#endif
+#endif
+
+#if defined(__GNUC__)
+#define VECTOR_COLD [[gnu::cold, gnu::noinline]]
+#define VECTOR_TRAP() __builtin_trap()
+#else
+#define VECTOR_COLD
+#define VECTOR_TRAP() std::abort()
+#endif
+
+namespace vector_check {
+
+VECTOR_COLD [[noreturn]] inline void check_failed(const char* what, size_t index, size_t size) noexcept {
+    std::fprintf(stderr, "Vector check failed: %s (index %zu, size %zu)\n", what, index, size);
+    std::abort();
+}
+
+VECTOR_COLD [[noreturn]] inline void throw_out_of_range(size_t index, size_t size) {
+    char message[80];
+    std::snprintf(message, sizeof(message), "Index %zu out of range (size: %zu)", index, size);
+    throw std::out_of_range(message);
+}
+
+VECTOR_COLD [[noreturn]] inline void throw_out_of_range(const char* message) {
+    throw std::out_of_range(message);
+}
+
+}
+
+#if VECTOR_CHECK_LEVEL == VECTOR_CHECK_TRAP
+#define VECTOR_CHECK(condition, what, index, size) \
+    do { \
+        if (!(condition)) [[unlikely]] { \
+            VECTOR_TRAP(); \
+        } \
+    } while (0)
+#elif VECTOR_CHECK_LEVEL == VECTOR_CHECK_ASSERT
+#define VECTOR_CHECK(condition, what, index, size) \
+    do { \
+        if (!(condition)) [[unlikely]] { \
+            vector_check::check_failed(what, static_cast<size_t>(index), static_cast<size_t>(size)); \
+        } \
+    } while (0)
+#else
+#define VECTOR_CHECK(condition, what, index, size) ((void)0)
+#endif
@@ -0,0 +1,454 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "vector.h"
+
+#if defined(VECTOR_SIMD_X86)
+#include <immintrin.h>
+#elif defined(VECTOR_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+// Numeric kernels over Vector's contiguous storage: sum, dot, min, max, axpy, scale and transform.
+//
+// Reductions run in math_mode::strict by default, which adds elements in index order and matches
+// std::accumulate bit for bit. math_mode::fast lets float/double reductions reassociate into several
+// SIMD accumulators (and contract into FMA), trading reproducibility for throughput.
+// min/max and the element-wise kernels do not depend on evaluation order and are vectorized in both
+// modes; with NaNs present, min/max follow the SIMD instructions rather than std::min_element.
+// The SIMD kernels peel a scalar head until the data is aligned to the register width, then use
+// aligned loads, then finish the tail with scalar code.
+namespace vector_ops {
+
+enum class math_mode { strict, fast };
+
+// Kernels marked VECTOR_OPS_NO_CONTRACT round every product before adding it, even in builds that
+// would otherwise contract a * b + c into an FMA (GCC outside ISO mode, clang, -ffp-contract=fast).
+// Clang has no attribute for this, so it takes VECTOR_OPS_NO_CONTRACT_SCOPE at the top of the body.
+#if defined(__clang__)
+#define VECTOR_OPS_NO_CONTRACT
+#define VECTOR_OPS_NO_CONTRACT_SCOPE _Pragma("clang fp contract(off)")
+#else
+#define VECTOR_OPS_NO_CONTRACT [[gnu::optimize("fp-contract=off")]]
+#define VECTOR_OPS_NO_CONTRACT_SCOPE
+#endif
+
+template <typename T>
+inline constexpr bool simd_float = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+#if defined(VECTOR_SIMD_X86)
+
+template <typename T>
+struct Avx2;
+
+template <>
+struct Avx2<float> {
+    using reg = __m256;
+    static constexpr size_t lanes = 8;
+
+    [[gnu::target("avx2,fma")]] static reg zero() noexcept { return _mm256_setzero_ps(); }
+    [[gnu::target("avx2,fma")]] static reg set1(float x) noexcept { return _mm256_set1_ps(x); }
+    [[gnu::target("avx2,fma")]] static reg load(const float* p) noexcept { return _mm256_load_ps(p); }
+    [[gnu::target("avx2,fma")]] static reg loadu(const float* p) noexcept { return _mm256_loadu_ps(p); }
+    [[gnu::target("avx2,fma")]] static void store(float* p, reg x) noexcept { _mm256_store_ps(p, x); }
+    [[gnu::target("avx2,fma")]] static reg add(reg a, reg b) noexcept { return _mm256_add_ps(a, b); }
+    [[gnu::target("avx2,fma")]] static reg mul(reg a, reg b) noexcept { return _mm256_mul_ps(a, b); }
+    [[gnu::target("avx2,fma")]] static reg fmadd(reg a, reg b, reg c) noexcept { return _mm256_fmadd_ps(a, b, c); }
+    [[gnu::target("avx2,fma")]] static reg min(reg a, reg b) noexcept { return _mm256_min_ps(a, b); }
+    [[gnu::target("avx2,fma")]] static reg max(reg a, reg b) noexcept { return _mm256_max_ps(a, b); }
+
+    [[gnu::target("avx2,fma")]] static void spill(reg x, float* out) noexcept { _mm256_storeu_ps(out, x); }
+};
+
+template <>
+struct Avx2<double> {
+    using reg = __m256d;
+    static constexpr size_t lanes = 4;
+
+    [[gnu::target("avx2,fma")]] static reg zero() noexcept { return _mm256_setzero_pd(); }
+    [[gnu::target("avx2,fma")]] static reg set1(double x) noexcept { return _mm256_set1_pd(x); }
+    [[gnu::target("avx2,fma")]] static reg load(const double* p) noexcept { return _mm256_load_pd(p); }
+    [[gnu::target("avx2,fma")]] static reg loadu(const double* p) noexcept { return _mm256_loadu_pd(p); }
+    [[gnu::target("avx2,fma")]] static void store(double* p, reg x) noexcept { _mm256_store_pd(p, x); }
+    [[gnu::target("avx2,fma")]] static reg add(reg a, reg b) noexcept { return _mm256_add_pd(a, b); }
+    [[gnu::target("avx2,fma")]] static reg mul(reg a, reg b) noexcept { return _mm256_mul_pd(a, b); }
+    [[gnu::target("avx2,fma")]] static reg fmadd(reg a, reg b, reg c) noexcept { return _mm256_fmadd_pd(a, b, c); }
+    [[gnu::target("avx2,fma")]] static reg min(reg a, reg b) noexcept { return _mm256_min_pd(a, b); }
+    [[gnu::target("avx2,fma")]] static reg max(reg a, reg b) noexcept { return _mm256_max_pd(a, b); }
+
+    [[gnu::target("avx2,fma")]] static void spill(reg x, double* out) noexcept { _mm256_storeu_pd(out, x); }
+};
+
+inline bool has_avx2_fma() noexcept {
+    static const bool value = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return value;
+}
+
+#define VECTOR_OPS_SIMD_TARGET [[gnu::target("avx2,fma")]]
+template <typename T>
+using Simd = Avx2<T>;
+inline bool simd_available() noexcept { return has_avx2_fma(); }
+
+#elif defined(VECTOR_SIMD_NEON)
+
+template <typename T>
+struct Neon;
+
+template <>
+struct Neon<float> {
+    using reg = float32x4_t;
+    static constexpr size_t lanes = 4;
+
+    static reg zero() noexcept { return vdupq_n_f32(0.0f); }
+    static reg set1(float x) noexcept { return vdupq_n_f32(x); }
+    static reg load(const float* p) noexcept { return vld1q_f32(p); }
+    static reg loadu(const float* p) noexcept { return vld1q_f32(p); }
+    static void store(float* p, reg x) noexcept { vst1q_f32(p, x); }
+    static reg add(reg a, reg b) noexcept { return vaddq_f32(a, b); }
+    static reg mul(reg a, reg b) noexcept { return vmulq_f32(a, b); }
+    static reg fmadd(reg a, reg b, reg c) noexcept { return vfmaq_f32(c, a, b); }
+    static reg min(reg a, reg b) noexcept { return vminq_f32(a, b); }
+    static reg max(reg a, reg b) noexcept { return vmaxq_f32(a, b); }
+
+    static void spill(reg x, float* out) noexcept { vst1q_f32(out, x); }
+};
+
+template <>
+struct Neon<double> {
+    using reg = float64x2_t;
+    static constexpr size_t lanes = 2;
+
+    static reg zero() noexcept { return vdupq_n_f64(0.0); }
+    static reg set1(double x) noexcept { return vdupq_n_f64(x); }
+    static reg load(const double* p) noexcept { return vld1q_f64(p); }
+    static reg loadu(const double* p) noexcept { return vld1q_f64(p); }
+    static void store(double* p, reg x) noexcept { vst1q_f64(p, x); }
+    static reg add(reg a, reg b) noexcept { return vaddq_f64(a, b); }
+    static reg mul(reg a, reg b) noexcept { return vmulq_f64(a, b); }
+    static reg fmadd(reg a, reg b, reg c) noexcept { return vfmaq_f64(c, a, b); }
+    static reg min(reg a, reg b) noexcept { return vminq_f64(a, b); }
+    static reg max(reg a, reg b) noexcept { return vmaxq_f64(a, b); }
+
+    static void spill(reg x, double* out) noexcept { vst1q_f64(out, x); }
+};
+
+#define VECTOR_OPS_SIMD_TARGET
+template <typename T>
+using Simd = Neon<T>;
+inline bool simd_available() noexcept { return true; }
+
+#endif
+
+#if defined(VECTOR_OPS_SIMD_TARGET)
+
+// Number of leading elements to process one by one before p + head is aligned to the register width.
+template <typename T>
+size_t aligned_head(const T* p, size_t n) noexcept {
+    constexpr size_t bytes = Simd<T>::lanes * sizeof(T);
+    size_t misalignment = reinterpret_cast<uintptr_t>(p) % bytes;
+    if (misalignment == 0) {
+        return 0;
+    }
+    if (misalignment % sizeof(T) != 0) {
+        return n;
+    }
+    size_t head = (bytes - misalignment) / sizeof(T);
+    return head < n ? head : n;
+}
+
+template <typename T>
+VECTOR_OPS_SIMD_TARGET T simd_sum(const T* p, size_t n) noexcept {
+    using S = Simd<T>;
+    constexpr size_t lanes = S::lanes;
+
+    size_t head = aligned_head(p, n);
+    T result = 0;
+    for (size_t i = 0; i < head; ++i) {
+        result += p[i];
+    }
+
+    typename S::reg acc0 = S::zero(), acc1 = S::zero(), acc2 = S::zero(), acc3 = S::zero();
+    size_t i = head;
+    for (; i + 4 * lanes <= n; i += 4 * lanes) {
+        acc0 = S::add(acc0, S::load(p + i));
+        acc1 = S::add(acc1, S::load(p + i + lanes));
+        acc2 = S::add(acc2, S::load(p + i + 2 * lanes));
+        acc3 = S::add(acc3, S::load(p + i + 3 * lanes));
+    }
+    for (; i + lanes <= n; i += lanes) {
+        acc0 = S::add(acc0, S::load(p + i));
+    }
+
+    T lanesOut[lanes];
+    S::spill(S::add(S::add(acc0, acc1), S::add(acc2, acc3)), lanesOut);
+    for (size_t l = 0; l < lanes; ++l) {
+        result += lanesOut[l];
+    }
+    for (; i < n; ++i) {
+        result += p[i];
+    }
+    return result;
+}
+
+template <typename T>
+VECTOR_OPS_SIMD_TARGET T simd_dot(const T* x, const T* y, size_t n) noexcept {
+    using S = Simd<T>;
+    constexpr size_t lanes = S::lanes;
+
+    size_t head = aligned_head(x, n);
+    T result = 0;
+    for (size_t i = 0; i < head; ++i) {
+        result += x[i] * y[i];
+    }
+
+    typename S::reg acc0 = S::zero(), acc1 = S::zero();
+    size_t i = head;
+    for (; i + 2 * lanes <= n; i += 2 * lanes) {
+        acc0 = S::fmadd(S::load(x + i), S::loadu(y + i), acc0);
+        acc1 = S::fmadd(S::load(x + i + lanes), S::loadu(y + i + lanes), acc1);
+    }
+    for (; i + lanes <= n; i += lanes) {
+        acc0 = S::fmadd(S::load(x + i), S::loadu(y + i), acc0);
+    }
+
+    T lanesOut[lanes];
+    S::spill(S::add(acc0, acc1), lanesOut);
+    for (size_t l = 0; l < lanes; ++l) {
+        result += lanesOut[l];
+    }
+    for (; i < n; ++i) {
+        result += x[i] * y[i];
+    }
+    return result;
+}
+
+// Requires n > 0.
+template <typename T, bool IsMax>
+VECTOR_OPS_SIMD_TARGET T simd_extremum(const T* p, size_t n) noexcept {
+    using S = Simd<T>;
+    constexpr size_t lanes = S::lanes;
+
+    T result = p[0];
+    size_t head = aligned_head(p, n);
+    for (size_t i = 1; i < head; ++i) {
+        result = IsMax ? (p[i] > result ? p[i] : result) : (p[i] < result ? p[i] : result);
+    }
+
+    size_t i = head;
+    if (i + lanes <= n) {
+        typename S::reg acc = S::set1(result);
+        for (; i + lanes <= n; i += lanes) {
+            acc = IsMax ? S::max(acc, S::load(p + i)) : S::min(acc, S::load(p + i));
+        }
+        T lanesOut[lanes];
+        S::spill(acc, lanesOut);
+        for (size_t l = 0; l < lanes; ++l) {
+            result = IsMax ? (lanesOut[l] > result ? lanesOut[l] : result) : (lanesOut[l] < result ? lanesOut[l] : result);
+        }
+    }
+    for (; i < n; ++i) {
+        result = IsMax ? (p[i] > result ? p[i] : result) : (p[i] < result ? p[i] : result);
+    }
+    return result;
+}
+
+// y[i] += a * x[i]; only the Fused kernel, through S::fmadd, skips rounding the product.
+template <typename T, bool Fused>
+VECTOR_OPS_SIMD_TARGET VECTOR_OPS_NO_CONTRACT void simd_axpy(T a, const T* x, T* y, size_t n) noexcept {
+    VECTOR_OPS_NO_CONTRACT_SCOPE
+    using S = Simd<T>;
+    constexpr size_t lanes = S::lanes;
+
+    size_t head = aligned_head(y, n);
+    for (size_t i = 0; i < head; ++i) {
+        y[i] += a * x[i];
+    }
+
+    typename S::reg va = S::set1(a);
+    size_t i = head;
+    for (; i + lanes <= n; i += lanes) {
+        typename S::reg vy = S::load(y + i);
+        typename S::reg vx = S::loadu(x + i);
+        S::store(y + i, Fused ? S::fmadd(va, vx, vy) : S::add(vy, S::mul(va, vx)));
+    }
+    for (; i < n; ++i) {
+        y[i] += a * x[i];
+    }
+}
+
+template <typename T>
+VECTOR_OPS_SIMD_TARGET void simd_scale(T* p, size_t n, T a) noexcept {
+    using S = Simd<T>;
+    constexpr size_t lanes = S::lanes;
+
+    size_t head = aligned_head(p, n);
+    for (size_t i = 0; i < head; ++i) {
+        p[i] *= a;
+    }
+
+    typename S::reg va = S::set1(a);
+    size_t i = head;
+    for (; i + lanes <= n; i += lanes) {
+        S::store(p + i, S::mul(S::load(p + i), va));
+    }
+    for (; i < n; ++i) {
+        p[i] *= a;
+    }
+}
+
+#endif
+
+template <math_mode Mode = math_mode::strict, typename T>
+T sum(const T* data, size_t n) noexcept {
+#if defined(VECTOR_OPS_SIMD_TARGET)
+    if constexpr (simd_float<T> && Mode == math_mode::fast) {
+        if (simd_available()) {
+            return simd_sum(data, n);
+        }
+    }
+#endif
+    T result = T();
+    for (size_t i = 0; i < n; ++i) {
+        result += data[i];
+    }
+    return result;
+}
+
+template <math_mode Mode = math_mode::strict, typename T>
+VECTOR_OPS_NO_CONTRACT T dot(const T* x, const T* y, size_t n) noexcept {
+    VECTOR_OPS_NO_CONTRACT_SCOPE
+#if defined(VECTOR_OPS_SIMD_TARGET)
+    if constexpr (simd_float<T> && Mode == math_mode::fast) {
+        if (simd_available()) {
+            return simd_dot(x, y, n);
+        }
+    }
+#endif
+    T result = T();
+    for (size_t i = 0; i < n; ++i) {
+        result += x[i] * y[i];
+    }
+    return result;
+}
+
+template <typename T>
+T min(const T* data, size_t n) {
+    if (n == 0) {
+        throw std::out_of_range("Vector is empty");
+    }
+#if defined(VECTOR_OPS_SIMD_TARGET)
+    if constexpr (simd_float<T>) {
+        if (simd_available()) {
+            return simd_extremum<T, false>(data, n);
+        }
+    }
+#endif
+    T result = data[0];
+    for (size_t i = 1; i < n; ++i) {
+        result = data[i] < result ? data[i] : result;
+    }
+    return result;
+}
+
+template <typename T>
+T max(const T* data, size_t n) {
+    if (n == 0) {
+        throw std::out_of_range("Vector is empty");
+    }
+#if defined(VECTOR_OPS_SIMD_TARGET)
+    if constexpr (simd_float<T>) {
+        if (simd_available()) {
+            return simd_extremum<T, true>(data, n);
+        }
+    }
+#endif
+    T result = data[0];
+    for (size_t i = 1; i < n; ++i) {
+        result = data[i] > result ? data[i] : result;
+    }
+    return result;
+}
+
+// y[i] += a * x[i]; math_mode::fast allows the multiply-add to be fused.
+template <math_mode Mode = math_mode::strict, typename T>
+VECTOR_OPS_NO_CONTRACT void axpy(T a, const T* x, T* y, size_t n) noexcept {
+    VECTOR_OPS_NO_CONTRACT_SCOPE
+#if defined(VECTOR_OPS_SIMD_TARGET)
+    if constexpr (simd_float<T>) {
+        if (simd_available()) {
+            simd_axpy<T, Mode == math_mode::fast>(a, x, y, n);
+            return;
+        }
+    }
+#endif
+    for (size_t i = 0; i < n; ++i) {
+        y[i] += a * x[i];
+    }
+}
+
+template <typename T>
+void scale(T* data, size_t n, T a) noexcept {
+#if defined(VECTOR_OPS_SIMD_TARGET)
+    if constexpr (simd_float<T>) {
+        if (simd_available()) {
+            simd_scale(data, n, a);
+            return;
+        }
+    }
+#endif
+    for (size_t i = 0; i < n; ++i) {
+        data[i] *= a;
+    }
+}
+
+template <math_mode Mode = math_mode::strict, typename T, class Alloc, class Growth, size_t N>
+T sum(const Vector<T, Alloc, Growth, N>& v) noexcept {
+    return sum<Mode>(v.data(), v.size());
+}
+
+template <math_mode Mode = math_mode::strict, typename T, class Alloc, class Growth, size_t N>
+T dot(const Vector<T, Alloc, Growth, N>& x, const Vector<T, Alloc, Growth, N>& y) {
+    if (x.size() != y.size()) {
+        throw std::invalid_argument("dot requires vectors of equal size");
+    }
+    return dot<Mode>(x.data(), y.data(), x.size());
+}
+
+template <typename T, class Alloc, class Growth, size_t N>
+T min(const Vector<T, Alloc, Growth, N>& v) {
+    return min(v.data(), v.size());
+}
+
+template <typename T, class Alloc, class Growth, size_t N>
+T max(const Vector<T, Alloc, Growth, N>& v) {
+    return max(v.data(), v.size());
+}
+
+template <math_mode Mode = math_mode::strict, typename T, class Alloc, class Growth, size_t N>
+void axpy(T a, const Vector<T, Alloc, Growth, N>& x, Vector<T, Alloc, Growth, N>& y) {
+    if (x.size() != y.size()) {
+        throw std::invalid_argument("axpy requires vectors of equal size");
+    }
+    axpy<Mode>(a, x.data(), y.data(), x.size());
+}
+
+template <typename T, class Alloc, class Growth, size_t N>
+void scale(Vector<T, Alloc, Growth, N>& v, T a) noexcept {
+    scale(v.data(), v.size(), a);
+}
+
+// Applies fn to every element in place; written as a plain indexed loop so the compiler can vectorize it.
+template <typename T, class Alloc, class Growth, size_t N, typename Fn>
+void transform_inplace(Vector<T, Alloc, Growth, N>& v, Fn fn) {
+    T* __restrict data = v.data();
+    size_t n = v.size();
+    for (size_t i = 0; i < n; ++i) {
+        data[i] = fn(data[i]);
+    }
+}
+
+}
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define VECTOR_SIMD_X86 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define VECTOR_SIMD_NEON 1
+#endif
+
+// Search kernels behind Vector::index/rfind/count for arithmetic element types.
+// x86 builds select AVX-512 or AVX2 at runtime, AArch64 always has NEON, anything else runs the scalar loop.
+// Every kernel returns npos when the value does not occur.
+namespace vector_simd {
+
+inline constexpr size_t npos = static_cast<size_t>(-1);
+
+template <typename T>
+inline constexpr bool supported = (std::is_integral_v<T> || std::is_same_v<T, float> || std::is_same_v<T, double>)
+    && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+template <typename T>
+size_t scalar_find(const T* data, size_t first, size_t last, T value) noexcept {
+    for (size_t i = first; i < last; ++i) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return npos;
+}
+
+template <typename T>
+size_t scalar_rfind(const T* data, size_t last, T value) noexcept {
+    for (size_t i = last; i-- > 0;) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return npos;
+}
+
+template <typename T>
+size_t scalar_count(const T* data, size_t first, size_t last, T value) noexcept {
+    size_t result = 0;
+    for (size_t i = first; i < last; ++i) {
+        result += data[i] == value;
+    }
+    return result;
+}
+
+#if defined(VECTOR_SIMD_X86)
+
+inline bool has_avx2() noexcept {
+    static const bool value = __builtin_cpu_supports("avx2");
+    return value;
+}
+
+inline bool has_avx512() noexcept {
+    static const bool value = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    return value;
+}
+
+// One bit per matching byte, i.e. sizeof(T) bits per matching element.
+template <typename T>
+[[gnu::target("avx2")]] inline uint32_t avx2_mask(const T* p, T value) noexcept {
+    __m256i eq;
+    if constexpr (std::is_same_v<T, float>) {
+        eq = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(p), _mm256_set1_ps(value), _CMP_EQ_OQ));
+    }
+    else if constexpr (std::is_same_v<T, double>) {
+        eq = _mm256_castpd_si256(_mm256_cmp_pd(_mm256_loadu_pd(p), _mm256_set1_pd(value), _CMP_EQ_OQ));
+    }
+    else {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        if constexpr (sizeof(T) == 1) {
+            eq = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(static_cast<char>(value)));
+        }
+        else if constexpr (sizeof(T) == 2) {
+            eq = _mm256_cmpeq_epi16(v, _mm256_set1_epi16(static_cast<short>(value)));
+        }
+        else if constexpr (sizeof(T) == 4) {
+            eq = _mm256_cmpeq_epi32(v, _mm256_set1_epi32(static_cast<int>(value)));
+        }
+        else {
+            eq = _mm256_cmpeq_epi64(v, _mm256_set1_epi64x(static_cast<long long>(value)));
+        }
+    }
+    return static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+}
+
+template <typename T>
+[[gnu::target("avx2")]] size_t avx2_find(const T* data, size_t n, T value) noexcept {
+    constexpr size_t lanes = 32 / sizeof(T);
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        if (uint32_t mask = avx2_mask(data + i, value)) {
+            return i + std::countr_zero(mask) / sizeof(T);
+        }
+    }
+    return scalar_find(data, i, n, value);
+}
+
+template <typename T>
+[[gnu::target("avx2")]] size_t avx2_rfind(const T* data, size_t n, T value) noexcept {
+    constexpr size_t lanes = 32 / sizeof(T);
+    size_t i = n;
+    for (; i >= lanes; i -= lanes) {
+        if (uint32_t mask = avx2_mask(data + i - lanes, value)) {
+            return i - lanes + (31 - std::countl_zero(mask)) / sizeof(T);
+        }
+    }
+    return scalar_rfind(data, i, value);
+}
+
+template <typename T>
+[[gnu::target("avx2")]] size_t avx2_count(const T* data, size_t n, T value) noexcept {
+    constexpr size_t lanes = 32 / sizeof(T);
+    size_t bits = 0;
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        bits += std::popcount(avx2_mask(data + i, value));
+    }
+    return bits / sizeof(T) + scalar_count(data, i, n, value);
+}
+
+// One bit per matching element.
+template <typename T>
+[[gnu::target("avx512f,avx512bw")]] inline uint64_t avx512_mask(const T* p, T value) noexcept {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm512_cmp_ps_mask(_mm512_loadu_ps(p), _mm512_set1_ps(value), _CMP_EQ_OQ);
+    }
+    else if constexpr (std::is_same_v<T, double>) {
+        return _mm512_cmp_pd_mask(_mm512_loadu_pd(p), _mm512_set1_pd(value), _CMP_EQ_OQ);
+    }
+    else {
+        __m512i v = _mm512_loadu_si512(p);
+        if constexpr (sizeof(T) == 1) {
+            return _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(static_cast<char>(value)));
+        }
+        else if constexpr (sizeof(T) == 2) {
+            return _mm512_cmpeq_epi16_mask(v, _mm512_set1_epi16(static_cast<short>(value)));
+        }
+        else if constexpr (sizeof(T) == 4) {
+            return _mm512_cmpeq_epi32_mask(v, _mm512_set1_epi32(static_cast<int>(value)));
+        }
+        else {
+            return _mm512_cmpeq_epi64_mask(v, _mm512_set1_epi64(static_cast<long long>(value)));
+        }
+    }
+}
+
+template <typename T>
+[[gnu::target("avx512f,avx512bw")]] size_t avx512_find(const T* data, size_t n, T value) noexcept {
+    constexpr size_t lanes = 64 / sizeof(T);
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        if (uint64_t mask = avx512_mask(data + i, value)) {
+            return i + std::countr_zero(mask);
+        }
+    }
+    return scalar_find(data, i, n, value);
+}
+
+template <typename T>
+[[gnu::target("avx512f,avx512bw")]] size_t avx512_rfind(const T* data, size_t n, T value) noexcept {
+    constexpr size_t lanes = 64 / sizeof(T);
+    size_t i = n;
+    for (; i >= lanes; i -= lanes) {
+        if (uint64_t mask = avx512_mask(data + i - lanes, value)) {
+            return i - lanes + (63 - std::countl_zero(mask));
+        }
+    }
+    return scalar_rfind(data, i, value);
+}
+
+template <typename T>
+[[gnu::target("avx512f,avx512bw")]] size_t avx512_count(const T* data, size_t n, T value) noexcept {
+    constexpr size_t lanes = 64 / sizeof(T);
+    size_t result = 0;
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        result += std::popcount(avx512_mask(data + i, value));
+    }
+    return result + scalar_count(data, i, n, value);
+}
+
+#elif defined(VECTOR_SIMD_NEON)
+
+// Four bits per matching byte, i.e. 4 * sizeof(T) bits per matching element.
+template <typename T>
+inline uint64_t neon_mask(const T* p, T value) noexcept {
+    uint8x16_t eq;
+    if constexpr (std::is_same_v<T, float>) {
+        eq = vreinterpretq_u8_u32(vceqq_f32(vld1q_f32(p), vdupq_n_f32(value)));
+    }
+    else if constexpr (std::is_same_v<T, double>) {
+        eq = vreinterpretq_u8_u64(vceqq_f64(vld1q_f64(p), vdupq_n_f64(value)));
+    }
+    else if constexpr (sizeof(T) == 1) {
+        eq = vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(p)), vdupq_n_u8(static_cast<uint8_t>(value)));
+    }
+    else if constexpr (sizeof(T) == 2) {
+        eq = vreinterpretq_u8_u16(vceqq_u16(vld1q_u16(reinterpret_cast<const uint16_t*>(p)),
+            vdupq_n_u16(static_cast<uint16_t>(value))));
+    }
+    else if constexpr (sizeof(T) == 4) {
+        eq = vreinterpretq_u8_u32(vceqq_u32(vld1q_u32(reinterpret_cast<const uint32_t*>(p)),
+            vdupq_n_u32(static_cast<uint32_t>(value))));
+    }
+    else {
+        eq = vreinterpretq_u8_u64(vceqq_u64(vld1q_u64(reinterpret_cast<const uint64_t*>(p)),
+            vdupq_n_u64(static_cast<uint64_t>(value))));
+    }
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+}
+
+template <typename T>
+size_t neon_find(const T* data, size_t n, T value) noexcept {
+    constexpr size_t lanes = 16 / sizeof(T);
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        if (uint64_t mask = neon_mask(data + i, value)) {
+            return i + std::countr_zero(mask) / (4 * sizeof(T));
+        }
+    }
+    return scalar_find(data, i, n, value);
+}
+
+template <typename T>
+size_t neon_rfind(const T* data, size_t n, T value) noexcept {
+    constexpr size_t lanes = 16 / sizeof(T);
+    size_t i = n;
+    for (; i >= lanes; i -= lanes) {
+        if (uint64_t mask = neon_mask(data + i - lanes, value)) {
+            return i - lanes + (63 - std::countl_zero(mask)) / (4 * sizeof(T));
+        }
+    }
+    return scalar_rfind(data, i, value);
+}
+
+template <typename T>
+size_t neon_count(const T* data, size_t n, T value) noexcept {
+    constexpr size_t lanes = 16 / sizeof(T);
+    size_t bits = 0;
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        bits += std::popcount(neon_mask(data + i, value));
+    }
+    return bits / (4 * sizeof(T)) + scalar_count(data, i, n, value);
+}
+
+#endif
+
+template <typename T>
+size_t find(const T* data, size_t n, T value) noexcept {
+#if defined(VECTOR_SIMD_X86)
+    if (has_avx512()) {
+        return avx512_find(data, n, value);
+    }
+    if (has_avx2()) {
+        return avx2_find(data, n, value);
+    }
+#elif defined(VECTOR_SIMD_NEON)
+    return neon_find(data, n, value);
+#endif
+    return scalar_find(data, 0, n, value);
+}
+
+template <typename T>
+size_t rfind(const T* data, size_t n, T value) noexcept {
+#if defined(VECTOR_SIMD_X86)
+    if (has_avx512()) {
+        return avx512_rfind(data, n, value);
+    }
+    if (has_avx2()) {
+        return avx2_rfind(data, n, value);
+    }
+#elif defined(VECTOR_SIMD_NEON)
+    return neon_rfind(data, n, value);
+#endif
+    return scalar_rfind(data, n, value);
+}
+
+template <typename T>
+size_t count(const T* data, size_t n, T value) noexcept {
+#if defined(VECTOR_SIMD_X86)
+    if (has_avx512()) {
+        return avx512_count(data, n, value);
+    }
+    if (has_avx2()) {
+        return avx2_count(data, n, value);
+    }
+#elif defined(VECTOR_SIMD_NEON)
+    return neon_count(data, n, value);
+#endif
+    return scalar_count(data, 0, n, value);
+}
+
+}
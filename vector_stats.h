@@ -0,0 +1,234 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+// Allocation, growth and copy counters for Vector, collected in a process-wide registry.
+//
+// A Vector is instrumented when its growth policy names an instrumentation type, as
+// InstrumentedGrowth<Base, Site> (vector.h) does; every other Vector compiles the hooks away. Counters
+// are kept per element type and site label, so two InstrumentedVector<int, "orderbook"> share an entry
+// while InstrumentedVector<int, "fills"> gets its own. vector_stats::for_each hands out a snapshot of
+// every entry and vector_stats::dump writes them as JSON lines for scraping.
+namespace vector_stats {
+
+// Name of T as spelled by the compiler, e.g. "int" or "std::__cxx11::basic_string<char>".
+template <typename T>
+constexpr std::string_view type_name() noexcept {
+#if defined(__clang__) || defined(__GNUC__)
+    std::string_view name = __PRETTY_FUNCTION__;
+    size_t first = name.find("T = ") + 4;
+    return name.substr(first, name.find_first_of(";]", first) - first);
+#elif defined(_MSC_VER)
+    std::string_view name = __FUNCSIG__;
+    size_t first = name.find("type_name<") + 10;
+    return name.substr(first, name.rfind(">(void)") - first);
+#else
+    return "unknown";
+#endif
+}
+
+// String literal usable as a template argument.
+template <size_t N>
+struct site_name {
+    char value[N] = {};
+
+    constexpr site_name(const char (&name)[N]) noexcept {
+        std::copy_n(name, N, value);
+    }
+};
+
+struct snapshot {
+    std::string_view type;
+    std::string_view site;
+    uint64_t allocations;       // heap blocks obtained plus blocks resized in place (try_expand, reallocate)
+    uint64_t deallocations;
+    uint64_t allocated_bytes;
+    uint64_t relocated_bytes;   // bytes relocated into another buffer by growth, shrink_to_fit and inline moves
+    uint64_t elements_copied;   // copy constructions and copy assignments
+    uint64_t elements_moved;    // elements relocated the same way
+    uint64_t peak_capacity;     // largest capacity any Vector of this entry reached, in elements
+    uint64_t wasted_capacity;   // sum of capacity - size whenever a heap buffer is destroyed or shrunk
+    uint64_t retired;           // number of those events
+};
+
+class counters {
+public:
+    counters(std::string_view type, std::string_view site) noexcept : type_(type), site_(site) {
+        next_ = head().load(std::memory_order_relaxed);
+        while (!head().compare_exchange_weak(next_, this, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    counters(const counters&) = delete;
+    counters& operator=(const counters&) = delete;
+
+    void allocated(size_t bytes, size_t capacity) noexcept {
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes_.fetch_add(bytes, std::memory_order_relaxed);
+        uint64_t peak = peakCapacity_.load(std::memory_order_relaxed);
+        while (peak < capacity
+            && !peakCapacity_.compare_exchange_weak(peak, capacity, std::memory_order_relaxed)) {
+        }
+    }
+
+    void deallocated() noexcept {
+        deallocations_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void moved(size_t count, size_t bytes) noexcept {
+        elementsMoved_.fetch_add(count, std::memory_order_relaxed);
+        relocatedBytes_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void copied(size_t count) noexcept {
+        elementsCopied_.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void retired(size_t wasted) noexcept {
+        wastedCapacity_.fetch_add(wasted, std::memory_order_relaxed);
+        retired_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] snapshot read() const noexcept {
+        return {type_, site_,
+            allocations_.load(std::memory_order_relaxed),
+            deallocations_.load(std::memory_order_relaxed),
+            allocatedBytes_.load(std::memory_order_relaxed),
+            relocatedBytes_.load(std::memory_order_relaxed),
+            elementsCopied_.load(std::memory_order_relaxed),
+            elementsMoved_.load(std::memory_order_relaxed),
+            peakCapacity_.load(std::memory_order_relaxed),
+            wastedCapacity_.load(std::memory_order_relaxed),
+            retired_.load(std::memory_order_relaxed)};
+    }
+
+    void reset() noexcept {
+        for (auto* counter : {&allocations_, &deallocations_, &allocatedBytes_, &relocatedBytes_, &elementsCopied_,
+                 &elementsMoved_, &peakCapacity_, &wastedCapacity_, &retired_}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] counters* next() const noexcept {
+        return next_;
+    }
+
+    // Entries register themselves here on first use and live until the end of the program.
+    static std::atomic<counters*>& head() noexcept {
+        static constinit std::atomic<counters*> first{nullptr};
+        return first;
+    }
+
+private:
+    std::string_view type_;
+    std::string_view site_;
+    counters* next_ = nullptr;
+    std::atomic<uint64_t> allocations_{0};
+    std::atomic<uint64_t> deallocations_{0};
+    std::atomic<uint64_t> allocatedBytes_{0};
+    std::atomic<uint64_t> relocatedBytes_{0};
+    std::atomic<uint64_t> elementsCopied_{0};
+    std::atomic<uint64_t> elementsMoved_{0};
+    std::atomic<uint64_t> peakCapacity_{0};
+    std::atomic<uint64_t> wastedCapacity_{0};
+    std::atomic<uint64_t> retired_{0};
+};
+
+template <typename T, site_name Site>
+counters& entry() noexcept {
+    static counters instance(type_name<T>(), std::string_view(Site.value));
+    return instance;
+}
+
+// Calls fn(const snapshot&) for every entry, most recently registered first.
+template <typename Fn>
+void for_each(Fn&& fn) {
+    for (const counters* c = counters::head().load(std::memory_order_acquire); c; c = c->next()) {
+        fn(c->read());
+    }
+}
+
+// One JSON object per line and entry.
+inline void dump(std::FILE* out = stderr) {
+    for_each([out](const snapshot& s) {
+        std::fprintf(out,
+            "{\"type\":\"%.*s\",\"site\":\"%.*s\",\"allocations\":%llu,\"deallocations\":%llu,"
+            "\"allocated_bytes\":%llu,\"relocated_bytes\":%llu,\"elements_copied\":%llu,\"elements_moved\":%llu,"
+            "\"peak_capacity\":%llu,\"wasted_capacity\":%llu,\"retired\":%llu}\n",
+            static_cast<int>(s.type.size()), s.type.data(), static_cast<int>(s.site.size()), s.site.data(),
+            static_cast<unsigned long long>(s.allocations), static_cast<unsigned long long>(s.deallocations),
+            static_cast<unsigned long long>(s.allocated_bytes), static_cast<unsigned long long>(s.relocated_bytes),
+            static_cast<unsigned long long>(s.elements_copied), static_cast<unsigned long long>(s.elements_moved),
+            static_cast<unsigned long long>(s.peak_capacity), static_cast<unsigned long long>(s.wasted_capacity),
+            static_cast<unsigned long long>(s.retired));
+    });
+}
+
+inline void reset() noexcept {
+    for (counters* c = counters::head().load(std::memory_order_acquire); c; c = c->next()) {
+        c->reset();
+    }
+}
+
+}
+
+// Hooks Vector calls at every allocation, relocation, copy and release of its storage.
+struct NoInstrumentation {
+    template <typename T>
+    struct hooks {
+        static constexpr void allocated(size_t) noexcept {}
+        static constexpr void deallocated() noexcept {}
+        static constexpr void moved(size_t) noexcept {}
+        static constexpr void copied(size_t) noexcept {}
+        static constexpr void retired(size_t, size_t) noexcept {}
+    };
+};
+
+template <vector_stats::site_name Site = "">
+struct CountingInstrumentation {
+    template <typename T>
+    struct hooks {
+        static void allocated(size_t capacity) noexcept {
+            vector_stats::entry<T, Site>().allocated(capacity * sizeof(T), capacity);
+        }
+
+        static void deallocated() noexcept {
+            vector_stats::entry<T, Site>().deallocated();
+        }
+
+        static void moved(size_t count) noexcept {
+            if (count > 0) {
+                vector_stats::entry<T, Site>().moved(count, count * sizeof(T));
+            }
+        }
+
+        static void copied(size_t count) noexcept {
+            if (count > 0) {
+                vector_stats::entry<T, Site>().copied(count);
+            }
+        }
+
+        static void retired(size_t capacity, size_t size) noexcept {
+            if (capacity > 0) {
+                vector_stats::entry<T, Site>().retired(capacity - size);
+            }
+        }
+    };
+};
+
+// The instrumentation named by a growth policy, or NoInstrumentation.
+template <typename Policy>
+struct instrumentation_of {
+    using type = NoInstrumentation;
+};
+
+template <typename Policy>
+    requires requires { typename Policy::instrumentation; }
+struct instrumentation_of<Policy> {
+    using type = typename Policy::instrumentation;
+};
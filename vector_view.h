@@ -0,0 +1,293 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#include "vector_simd.h"
+
+// Search loops shared by Vector, StaticVector and VectorView: the vector_simd kernels at run time and
+// a plain loop in constant expressions or for element types the kernels do not cover.
+namespace vector_detail {
+
+inline constexpr size_t npos = static_cast<size_t>(-1);
+
+template <typename T>
+constexpr size_t index(const T* data, size_t size, const T& element) {
+    if constexpr (vector_simd::supported<T>) {
+        if (!std::is_constant_evaluated()) {
+            return vector_simd::find(data, size, element);
+        }
+    }
+    const T* it = std::find(data, data + size, element);
+    return it != data + size ? static_cast<size_t>(it - data) : npos;
+}
+
+template <typename T>
+constexpr size_t rfind(const T* data, size_t size, const T& element) {
+    if constexpr (vector_simd::supported<T>) {
+        if (!std::is_constant_evaluated()) {
+            return vector_simd::rfind(data, size, element);
+        }
+    }
+    for (size_t i = size; i-- > 0;) {
+        if (data[i] == element) {
+            return i;
+        }
+    }
+    return npos;
+}
+
+template <typename T>
+constexpr size_t count(const T* data, size_t size, const T& element) {
+    if constexpr (vector_simd::supported<T>) {
+        if (!std::is_constant_evaluated()) {
+            return vector_simd::count(data, size, element);
+        }
+    }
+    return static_cast<size_t>(std::count(data, data + size, element));
+}
+
+}
+
+// Non-owning views over contiguous storage.
+//
+// VectorView<T> is a pointer and a length with Vector's read API (at, front/back, index, rfind, count,
+// contains) on top; it can wrap a buffer that came from a C API or an I/O layer without copying, and
+// converts to and from std::span. Vector::slice returns one. StridedView<T> walks every stride-th
+// element, e.g. one column of a row-major matrix. Both stay valid only as long as the storage does, and
+// both work in constant expressions over a constexpr Vector.
+template <typename T>
+class StridedView {
+public:
+    using value_type = std::remove_cv_t<T>;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+
+    class Iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_cv_t<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+    private:
+        // Only base + index * stride for an index below the view's size is ever formed, so end() does
+        // not point past the underlying array.
+        T* base;
+        difference_type index;
+        difference_type stride;
+
+    public:
+        constexpr Iterator(T* b = nullptr, difference_type i = 0, difference_type s = 1) noexcept : base(b), index(i), stride(s) {}
+
+        constexpr reference operator*() const noexcept { return base[index * stride]; }
+        constexpr pointer operator->() const noexcept { return base + index * stride; }
+        constexpr reference operator[](difference_type n) const noexcept { return base[(index + n) * stride]; }
+
+        constexpr Iterator& operator++() noexcept {
+            ++index;
+            return *this;
+        }
+
+        constexpr Iterator operator++(int) noexcept {
+            Iterator tmp(*this);
+            ++index;
+            return tmp;
+        }
+
+        constexpr Iterator& operator--() noexcept {
+            --index;
+            return *this;
+        }
+
+        constexpr Iterator operator--(int) noexcept {
+            Iterator tmp(*this);
+            --index;
+            return tmp;
+        }
+
+        constexpr Iterator& operator+=(difference_type n) noexcept {
+            index += n;
+            return *this;
+        }
+
+        constexpr Iterator operator+(difference_type n) const noexcept {
+            Iterator tmp(*this);
+            tmp += n;
+            return tmp;
+        }
+
+        friend constexpr Iterator operator+(difference_type n, const Iterator& it) noexcept {
+            return it + n;
+        }
+
+        constexpr Iterator& operator-=(difference_type n) noexcept {
+            index -= n;
+            return *this;
+        }
+
+        constexpr Iterator operator-(difference_type n) const noexcept {
+            Iterator tmp(*this);
+            tmp -= n;
+            return tmp;
+        }
+
+        constexpr difference_type operator-(const Iterator& other) const noexcept {
+            return index - other.index;
+        }
+
+        constexpr bool operator==(const Iterator& other) const noexcept {
+            return index == other.index;
+        }
+
+        constexpr auto operator<=>(const Iterator& other) const noexcept {
+            return index <=> other.index;
+        }
+    };
+
+    constexpr StridedView() noexcept = default;
+    constexpr StridedView(T* first, size_t count, difference_type stride) noexcept : data_(first), size_(count), stride_(stride) {}
+
+    constexpr Iterator begin() const noexcept { return Iterator(data_, 0, stride_); }
+    constexpr Iterator end() const noexcept { return Iterator(data_, static_cast<difference_type>(size_), stride_); }
+
+    [[nodiscard]] constexpr size_t size() const noexcept { return size_; }
+    [[nodiscard]] constexpr bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] constexpr difference_type stride() const noexcept { return stride_; }
+
+    constexpr reference operator[](size_t index) const noexcept { return data_[static_cast<difference_type>(index) * stride_]; }
+
+    constexpr reference at(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return (*this)[index];
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+    difference_type stride_ = 1;
+};
+
+template <typename T>
+class VectorView {
+public:
+    using value_type = std::remove_cv_t<T>;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using Iterator = T*;
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    constexpr VectorView() noexcept = default;
+    constexpr VectorView(T* data, size_t size) noexcept : data_(data), size_(size) {}
+    constexpr VectorView(std::span<T> span) noexcept : data_(span.data()), size_(span.size()) {}
+
+    // Any contiguous container whose elements convert by qualification, e.g. a Vector<int> into a
+    // VectorView<const int>.
+    template <std::ranges::contiguous_range R>
+        requires std::ranges::sized_range<R> && (!std::is_same_v<std::remove_cv_t<R>, VectorView>)
+        && std::is_convertible_v<std::remove_reference_t<std::ranges::range_reference_t<R>> (*)[], T (*)[]>
+    constexpr VectorView(R& range) noexcept : data_(std::ranges::data(range)), size_(static_cast<size_t>(std::ranges::size(range))) {}
+
+    constexpr operator std::span<T>() const noexcept { return {data_, size_}; }
+
+    constexpr operator VectorView<const T>() const noexcept
+        requires(!std::is_const_v<T>)
+    {
+        return {data_, size_};
+    }
+
+    constexpr Iterator begin() const noexcept { return data_; }
+    constexpr Iterator end() const noexcept { return data_ + size_; }
+
+    [[nodiscard]] constexpr T* data() const noexcept { return data_; }
+    [[nodiscard]] constexpr size_t size() const noexcept { return size_; }
+    [[nodiscard]] constexpr bool empty() const noexcept { return size_ == 0; }
+
+    constexpr reference operator[](size_t index) const noexcept { return data_[index]; }
+
+    constexpr reference at(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data_[index];
+    }
+
+    constexpr reference front() const {
+        if (empty()) {
+            throw std::out_of_range("View is empty");
+        }
+        return data_[0];
+    }
+
+    constexpr reference back() const {
+        if (empty()) {
+            throw std::out_of_range("View is empty");
+        }
+        return data_[size_ - 1];
+    }
+
+    // count elements starting at first.
+    [[nodiscard]] constexpr VectorView slice(size_t first, size_t count) const {
+        if (first > size_ || count > size_ - first) {
+            throw std::out_of_range("Slice out of range");
+        }
+        return {data_ + first, count};
+    }
+
+    // Elements first, first + stride, first + 2 * stride, ... up to the end of the view.
+    [[nodiscard]] constexpr StridedView<T> strided(size_t first, size_t stride) const {
+        if (stride == 0 || first > size_) {
+            throw std::out_of_range("Invalid stride or start");
+        }
+        return {data_ + first, (size_ - first + stride - 1) / stride, static_cast<difference_type>(stride)};
+    }
+
+    constexpr bool contains(const value_type& element) const {
+        return index(element) != npos;
+    }
+
+    // Position of the first occurrence of element, or npos.
+    constexpr size_t index(const value_type& element) const {
+        return vector_detail::index<value_type>(data_, size_, element);
+    }
+
+    // Position of the last occurrence of element, or npos.
+    constexpr size_t rfind(const value_type& element) const {
+        return vector_detail::rfind<value_type>(data_, size_, element);
+    }
+
+    constexpr size_t count(const value_type& element) const {
+        return vector_detail::count<value_type>(data_, size_, element);
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+template <typename T>
+inline constexpr bool std::ranges::enable_borrowed_range<VectorView<T>> = true;
+
+template <typename T>
+inline constexpr bool std::ranges::enable_borrowed_range<StridedView<T>> = true;
+
+// Ownership of a heap buffer handed out by Vector::release(): size constructed elements in room for
+// capacity, allocated by the Vector's allocator.
+template <typename T>
+struct VectorBuffer {
+    T* data = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+};